@@ -2,10 +2,10 @@
 #define LIBARGPARSE_ARGPARSE_HPP
 
 #include "argument.hpp"
+#include "command_line.hpp"
+#include "schema.hpp"
 
-#include <list>
 #include <vector>
-#include <limits>
 #include <cstdint>
 
 namespace argparse {
@@ -16,53 +16,70 @@ public:
     /**
      * Parsing result status codes.
      */
-    enum class Result : unsigned short
-    {
-        Success = 0,
-        InsufficientArguments,      // too less arguments given
-        MissingArgument,            // a required argument not provided
-
-        Unknown = std::numeric_limits<unsigned short>::max(),
-    };
+    using Result = ArgumentParserResult;
 
     /**
      * Returns a list of missing arguments once they were `parsed()`.
      */
-    inline const std::list<std::string> &missingArguments() const
+    inline const ParsedArguments::StringList &missingArguments() const
+    {
+        return this->parsedArguments.missingArguments();
+    }
+
+    /**
+     * Returns a list of abbreviated options which match multiple arguments.
+     */
+    inline const ParsedArguments::StringList &ambiguousArguments() const
     {
-        return this->_missingArguments;
+        return this->parsedArguments.ambiguousArguments();
     }
 
     /**
      * Returns a list of all lose arguments which didn't belong to an string option.
      */
-    inline const std::list<std::string> &loseArguments() const
+    inline const ParsedArguments::StringList &loseArguments() const
     {
-        return this->_loseArguments;
+        return this->parsedArguments.loseArguments();
     }
 
     /**
      * Returns a list of all remaining arguments which weren't parsed
      * due to termination.
      */
-    inline const std::list<std::string> &remainingArguments() const
+    inline const ParsedArguments::StringList &remainingArguments() const
     {
-        return this->_remainingArguments;
+        return this->parsedArguments.remainingArguments();
     }
 
     /**
      * Create an instance of the ArgumentParser and pass it the given
      * arguments as argument. The constructor only prepares some internals.
      * To do the actual parsing, call the `parse()` method.
+     *
+     * The copied arguments and everything allocated while parsing
+     * comes from the given memory resource.
      */
-    ArgumentParser(int argc, char **argv, const std::string &shortOptionPrefix = "-", const std::string &longOptionPrefix = "--");
+    ArgumentParser(int argc, char **argv, const std::string &shortOptionPrefix = "-", const std::string &longOptionPrefix = "--",
+                   std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
     /**
      * Create an instance of the ArgumentParser and pass it the given
      * arguments as argument. The constructor only prepares some internals.
      * To do the actual parsing, call the `parse()` method.
      */
-    ArgumentParser(const std::vector<std::string> &args, const std::string &shortOptionPrefix = "-", const std::string &longOptionPrefix = "--");
+    ArgumentParser(const std::vector<std::string> &args, const std::string &shortOptionPrefix = "-", const std::string &longOptionPrefix = "--",
+                   std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    /**
+     * Create an instance of the ArgumentParser which borrows the given
+     * arguments instead of copying them. Parsed values are views into the
+     * borrowed strings, which must outlive the parser.
+     *
+     * Use `ArgumentParser parser(CommandLine(argc, argv));` to parse
+     * the arguments of `main()` without any copies.
+     */
+    ArgumentParser(const CommandLine &commandLine, const std::string &shortOptionPrefix = "-", const std::string &longOptionPrefix = "--",
+                   std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
     /**
      * Adds a new argument to the argument parser.
@@ -74,15 +91,90 @@ public:
     inline bool addArgument(Args&&... args)
     {
         if (this->parsed) return false;
+        return this->schema.addArgument(args...);
+    }
 
-        if constexpr (sizeof...(args) == 1)
-        {
-            return this->addArgumentInternal(args...);
-        }
-        else
-        {
-            return this->addArgumentInternal(Argument(args...));
-        }
+    /**
+     * Adds a new argument and returns a handle to read its value without looking up
+     * the name, see `ArgumentSchema::addTypedArgument()`.
+     */
+    template<typename T = std::string, typename... Args>
+    inline ArgumentHandle<T> addTypedArgument(Args&&... args)
+    {
+        if (this->parsed) return ArgumentHandle<T>();
+        return this->schema.template addTypedArgument<T>(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Returns a handle for an already added argument, see `ArgumentSchema::handle()`.
+     */
+    template<typename T = std::string>
+    inline ArgumentHandle<T> handle(std::string_view name) const
+    {
+        return this->schema.template handle<T>(name);
+    }
+
+    /**
+     * Writes the value of the given argument into the variable once parsing succeeded,
+     * see `ArgumentBindings`. Use `std::vector<T>` variables for `Append` arguments.
+     * Returns false if there is no such argument.
+     */
+    template<typename T>
+    inline bool bind(std::string_view name, T *target)
+    {
+        return this->bind(this->schema.template handle<T>(name), target);
+    }
+
+    template<typename T>
+    inline bool bind(ArgumentHandle<T> handle, T *target)
+    {
+        if (this->parsed || !handle.isValid() || handle.position() >= this->schema.definitions().size() || !target) return false;
+        this->bindings.bind(handle.position(), target);
+        return true;
+    }
+
+    /**
+     * Lets the given argument fall back to the value of an environment variable,
+     * see `ArgumentSchema::setEnvironmentVariable()`.
+     */
+    inline bool setEnvironmentVariable(const std::string &argument, const std::string &variable)
+    {
+        if (this->parsed) return false;
+        return this->schema.setEnvironmentVariable(argument, variable);
+    }
+
+    /**
+     * Adds a positional argument, which takes the values that don't belong to an option.
+     *
+     * The arity is the number of values the argument takes: exactly one (`Positional::One`),
+     * zero or one (`Positional::Optional`), any number (`Positional::Any`) or at least one
+     * (`Positional::AtLeastOne`). The values are assigned in order of registration, arguments
+     * with a variable number of values take as many as possible. Missing values are reported
+     * like missing required options, values which no positional argument takes are lose arguments.
+     */
+    inline bool addPositional(const std::string &name, const std::string &description, Positional::Arity arity = Positional::One)
+    {
+        if (this->parsed) return false;
+        return this->schema.addPositional(name, description, arity);
+    }
+
+    /**
+     * Adds a subcommand whose arguments are registered by the given factory once
+     * the subcommand is selected, see `ArgumentSchema::addSubcommand()`.
+     */
+    inline bool addSubcommand(const std::string &name, const std::string &description, Subcommand::Factory factory)
+    {
+        if (this->parsed) return false;
+        return this->schema.addSubcommand(name, description, std::move(factory));
+    }
+
+    /**
+     * Reserves memory for the given number of arguments, see `ArgumentSchema::reserve()`.
+     */
+    inline void reserve(std::size_t count)
+    {
+        if (this->parsed) return;
+        this->schema.reserve(count);
     }
 
     /**
@@ -92,7 +184,7 @@ public:
     inline bool addHelpOption(const std::string &description)
     {
         if (this->parsed) return false;
-        return this->addArgument(Argument("h", "help", description, Argument::Boolean, false));
+        return this->schema.addHelpOption(description);
     }
 
     /**
@@ -102,7 +194,35 @@ public:
     inline void setTerminator(const std::string &terminator = "--")
     {
         if (this->parsed) return;
-        this->terminator = terminator;
+        this->schema.setTerminator(terminator);
+    }
+
+    /**
+     * Accepts unique prefixes of long option names, see `ArgumentSchema::enableAbbreviations()`.
+     */
+    inline void enableAbbreviations(bool enable = true)
+    {
+        if (this->parsed) return;
+        this->schema.enableAbbreviations(enable);
+    }
+
+    /**
+     * Enables `@file` response files, see `ArgumentSchema::enableResponseFiles()`.
+     */
+    inline void enableResponseFiles(std::uint8_t maxDepth = 8)
+    {
+        if (this->parsed) return;
+        this->schema.enableResponseFiles(maxDepth);
+    }
+
+    /**
+     * Reads `key = value` lines of the given file for arguments which aren't
+     * on the command line, see `ArgumentSchema::parse()`.
+     */
+    inline void setConfigFile(const std::string &path)
+    {
+        if (this->parsed) return;
+        this->configFile = path;
     }
 
     /**
@@ -129,14 +249,55 @@ public:
      * This overload supports visualizing string options with a custom
      * value suffix (defaults to `" [value]"`).
      */
-    const std::string help(
+    inline const std::string help(
         bool visualizeStringOptions, const std::string &stringOptionSuffix = " [value]",
-        std::uint8_t indentation = 4, std::uint8_t spacing = 10) const;
+        std::uint8_t indentation = 4, std::uint8_t spacing = 10) const
+    {
+        return this->schema.help(visualizeStringOptions, stringOptionSuffix, indentation, spacing);
+    }
+
+    /**
+     * Formats the help of the given subcommand, see `help()`. The arguments of the
+     * subcommand are registered for this if it wasn't selected.
+     */
+    inline const std::string subcommandHelp(
+        const std::string &name, bool visualizeStringOptions = false, const std::string &stringOptionSuffix = " [value]",
+        std::uint8_t indentation = 4, std::uint8_t spacing = 10) const
+    {
+        const auto subcommand = this->schema.subcommand(name);
+        return subcommand ? subcommand->help(visualizeStringOptions, stringOptionSuffix, indentation, spacing) : "";
+    }
+
+    /**
+     * Result of the selected subcommand, with the same accessors as the parser,
+     * or `nullptr` if no subcommand was selected.
+     */
+    inline const ParsedArguments *subcommand() const
+    {
+        return this->parsedArguments.subcommand();
+    }
+
+    /**
+     * Name of the selected subcommand, empty if no subcommand was selected.
+     */
+    inline std::string_view subcommandName() const
+    {
+        return this->parsedArguments.subcommandName();
+    }
 
     /**
      * Is the given argument present on the command line?
      */
-    bool exists(const std::string &name) const;
+    inline bool exists(std::string_view name) const
+    {
+        return this->parsedArguments.exists(name);
+    }
+
+    template<typename T>
+    inline bool exists(ArgumentHandle<T> handle) const
+    {
+        return this->parsedArguments.exists(handle);
+    }
 
     /**
      * Returns the parsed value of the given argument.
@@ -154,68 +315,86 @@ public:
      * casting a string representation of the boolean into an actual boolean.
      */
     template<typename T = std::string>
-    auto get(const std::string name, bool *ok = nullptr) const
-    {
-        if (this->parsingResult != Result::Success)
-        {
-            if (ok) *ok = false;
-            return T{};
-        }
-
-        if constexpr (std::is_same_v<T, bool>)
-        {
-            if (ok) *ok = true;
-            return this->exists(name);
-        }
-        else
-        {
-            for (auto&& arg : this->arguments)
-            {
-                if (arg.present() && (arg.name() == name || arg.shortName() == name || arg.longName() == name))
-                {
-                    if (ok) *ok = true;
-                    return arg.get<T>(ok);
-                }
-            }
-
-            if (ok) *ok = false;
-            return T{};
-        }
+    auto get(std::string_view name, bool *ok = nullptr) const
+    {
+        return this->parsedArguments.get<T>(name, ok);
+    }
+
+    /**
+     * Returns the parsed value of the argument of the handle as the type of the handle,
+     * the slot of the argument is read directly without looking up the name.
+     */
+    template<typename T>
+    inline T get(ArgumentHandle<T> handle, bool *ok = nullptr) const
+    {
+        return this->parsedArguments.get(handle, ok);
+    }
+
+    /**
+     * Returns all values of an `Append` argument in command line order,
+     * `--define a --define b` has the values `a` and `b`.
+     *
+     * The default returns views into the parsed command line without copying
+     * any value. Other types are converted like `get()` and returned as vector,
+     * `ok` is false when any value couldn't be converted.
+     *
+     * An argument which isn't present has no values, the default value isn't used.
+     */
+    template<typename T = std::string_view>
+    auto getAll(std::string_view name, bool *ok = nullptr) const
+    {
+        return this->parsedArguments.getAll<T>(name, ok);
+    }
+
+    /**
+     * Returns all values of the given positional argument in command line order,
+     * as views into the parsed command line.
+     */
+    inline Span<const std::string_view> positionals(std::string_view name) const
+    {
+        return this->parsedArguments.positionals(name);
+    }
+
+    /**
+     * Returns the value at the given index of the given positional argument.
+     *
+     * If there is no such value or a casting error ocurred a default
+     * initialized value will be returned. Numbers are converted once and cached.
+     */
+    template<typename T = std::string>
+    T positional(std::string_view name, std::size_t index = 0, bool *ok = nullptr) const
+    {
+        return this->parsedArguments.positional<T>(name, index, ok);
     }
 
 public:
-    using Arguments = std::list<Argument>;
+    using Arguments = ArgumentSchema::Arguments;
 
 private:
     ArgumentParser() = delete;                       // disallow default construction
     ArgumentParser(const ArgumentParser &) = delete; // disallow copy
 
     bool parsed = false;
-    Result parsingResult = Result::Unknown;
 
-    // copy of command line arguments
-    std::vector<std::string> args;
+    // copy of command line arguments, empty when the arguments are borrowed
+    StringList args;
 
-    // internal arguments array
-    Arguments arguments;
+    // the arguments to parse, views either into `args` or into borrowed strings
+    CommandLine commandLine{this->args};
 
-    std::list<std::string> argumentsLongRegistry;
-    std::list<std::string> argumentsShortRegistry;
+    // registered arguments
+    ArgumentSchema schema;
 
-    std::string shortOptionPrefix = "-";
-    std::string longOptionPrefix = "--";
-    std::string terminator = "";
+    // fallback for arguments which aren't on the command line, unused when empty
+    std::string configFile;
 
-    std::list<std::string> _missingArguments;
-    std::list<std::string> _loseArguments;
-    std::list<std::string> _remainingArguments;
+    // variables which receive the values after parsing
+    ArgumentBindings bindings;
 
-private:
-    bool addArgumentInternal(Argument argument);
+    // result of the `parse()` call
+    ParsedArguments parsedArguments;
 };
 
-using ArgumentParserResult = ArgumentParser::Result;
-
 } // namespace argparse
 
 #endif // LIBARGPARSE_ARGPARSE_HPP
@@ -1,15 +1,20 @@
 #ifndef LIBARGPARSE_ARGUMENT_HPP
 #define LIBARGPARSE_ARGUMENT_HPP
 
+#include "converters.hpp"
+
 #include <string>
+#include <string_view>
 #include <optional>
 #include <type_traits>
-#include <charconv>
 #include <cstring>
+#include <cstddef>
 
 namespace argparse {
 
-struct ArgumentParser;
+struct ArgumentSchema;
+struct ParsedArguments;
+struct ArgumentDefinition;
 
 struct Argument final
 {
@@ -18,6 +23,7 @@ public:
     {
         String,  /// when present, next argument must be a value for the `Argument`
         Boolean, /// when present, next argument must be an `Argument`
+        Append,  /// like `String`, but every occurrence adds another value, see `getAll()`
     };
 
     explicit Argument(
@@ -76,6 +82,20 @@ public:
         return this->_defaultValue;
     }
 
+    inline const auto &environmentVariable() const
+    {
+        return this->_environmentVariable;
+    }
+
+    /**
+     * name of an environment variable which supplies the value when the argument
+     * isn't on the command line, it takes precedence over the default value
+     */
+    inline void setEnvironmentVariable(const std::string &name)
+    {
+        this->_environmentVariable = name;
+    }
+
     /**
      * at least one variant must be set
      */
@@ -137,6 +157,11 @@ public:
         }
     }
 
+    /**
+     * returns a view of the definition of this argument
+     */
+    inline ArgumentDefinition definition() const;
+
     /**
      * attempt to convert the value to the given type
      */
@@ -148,7 +173,7 @@ public:
         {
             result = Argument::convert_helper<T>(this->_defaultValue.value());
         }
-        else
+        else if (this->hasValue())
         {
             result = Argument::convert_helper<T>(this->_value.value());
         }
@@ -165,6 +190,9 @@ public:
         }
     }
 
+    /**
+     * stores a copy of the given value
+     */
     void setValue(const std::string &value)
     {
         this->_value = value;
@@ -198,6 +226,7 @@ private:
     bool _present = false;
 
     std::optional<std::string> _defaultValue;
+    std::string _environmentVariable;
 
 private:
     /**
@@ -214,86 +243,228 @@ private:
         }
     }
 
-    friend argparse::ArgumentParser;
+    friend argparse::ArgumentSchema;
+    friend argparse::ParsedArguments;
 
     /**
-     * convertion helper from string to several data types
-     *
-     * supported:
-     *  - std::string
-     *  - bool
-     *  - integral types
-     *  - floating point types
+     * convertion helper from string to several data types,
+     * dispatches to the `converter<T>` of the type
      *
      * on unsupported input or casting errors, a `nullopt` is returned
      */
     template<typename T = std::string>
-    static const std::optional<T> convert_helper(const std::string &value)
+    static const std::optional<T> convert_helper(std::string_view value)
     {
-        try
-        {
-            // check string first, as this may be the most required usage
-            if constexpr (std::is_same_v<T, std::string>)
-            {
-                return value;
-            }
-            // check boolean before integral types, because bool is an integral type too
-            else if constexpr (std::is_same_v<T, bool>)
-            {
-                if (value == "true")
-                {
-                    return true;
-                }
-                else if (value == "false")
-                {
-                    return false;
-                }
-                else
-                {
-                    return std::nullopt;
-                }
-            }
-            // check all integral types
-            else if constexpr (std::is_integral_v<T>)
-            {
-                T parsed{};
-                const char* end = std::strchr(value.c_str(), 0);
-                const auto res = std::from_chars(value.c_str(), end, parsed);
-                if (!static_cast<bool>(res.ec) && res.ptr == end)
-                {
-                    return parsed;
-                }
-                else
-                {
-                    return std::nullopt;
-                }
-            }
-            // check floating point types
-            else if constexpr (std::is_floating_point_v<T> && std::is_same_v<T, float>)
-            {
-                return std::stof(value);
-            }
-            else if constexpr (std::is_floating_point_v<T> && std::is_same_v<T, double>)
-            {
-                return std::stod(value);
-            }
-            else if constexpr (std::is_floating_point_v<T> && std::is_same_v<T, long double>)
-            {
-                return std::stold(value);
-            }
-            // unsupported input
-            else
-            {
-                return std::nullopt;
-            }
-        }
-        catch (...)
+        return converter<T>::convert(value);
+    }
+};
+
+/**
+ * Non-owning view of an argument definition.
+ *
+ * Can be used in constant expressions, see `makeStaticSchema()`.
+ * The viewed strings must outlive the definition.
+ */
+struct ArgumentDefinition final
+{
+public:
+    constexpr ArgumentDefinition(
+        std::string_view shortName, std::string_view longName, std::string_view description,
+        Argument::Type type = Argument::String, bool required = false)
+        :
+        _shortName(shortName),
+        _longName(longName),
+        _description(description),
+        _type(type),
+        _required(required)
+    {
+    }
+
+    constexpr ArgumentDefinition(
+        std::string_view shortName, std::string_view longName, std::string_view description,
+        std::string_view defaultValue,
+        Argument::Type type = Argument::String, bool required = false)
+        :
+        _shortName(shortName),
+        _longName(longName),
+        _description(description),
+        _defaultValue(defaultValue),
+        _type(type),
+        _required(required),
+        _hasDefaultValue(true)
+    {
+    }
+
+    constexpr std::string_view shortName() const
+    {
+        return this->_shortName;
+    }
+
+    constexpr std::string_view longName() const
+    {
+        return this->_longName;
+    }
+
+    constexpr std::string_view description() const
+    {
+        return this->_description;
+    }
+
+    constexpr Argument::Type type() const
+    {
+        return this->_type;
+    }
+
+    constexpr bool required() const
+    {
+        return this->_required;
+    }
+
+    constexpr std::optional<std::string_view> defaultValue() const
+    {
+        if (this->_hasDefaultValue)
         {
-            return std::nullopt;
+            return this->_defaultValue;
         }
+        return std::nullopt;
     }
+
+    constexpr std::string_view environmentVariable() const
+    {
+        return this->_environmentVariable;
+    }
+
+    constexpr bool hasEnvironmentVariable() const
+    {
+        return this->_environmentVariable.size() > 0;
+    }
+
+    /**
+     * returns a copy of the definition whose value falls back to the given
+     * environment variable when the argument isn't on the command line
+     */
+    constexpr ArgumentDefinition withEnvironmentVariable(std::string_view name) const
+    {
+        ArgumentDefinition definition = *this;
+        definition._environmentVariable = name;
+        return definition;
+    }
+
+    /**
+     * at least one variant must be set
+     */
+    constexpr bool isValid() const
+    {
+        return this->hasShortName() || this->hasLongName();
+    }
+
+    constexpr bool hasShortName() const
+    {
+        return this->_shortName.size() > 0;
+    }
+
+    constexpr bool hasLongName() const
+    {
+        return this->_longName.size() > 0;
+    }
+
+    constexpr bool hasDefaultValue() const
+    {
+        return this->_hasDefaultValue;
+    }
+
+    /**
+     * returns the name of the option, longName is preferred, falls back to shortName
+     */
+    constexpr std::string_view name() const
+    {
+        return this->hasLongName() ? this->_longName : this->_shortName;
+    }
+
+private:
+    std::string_view _shortName;
+    std::string_view _longName;
+    std::string_view _description;
+    std::string_view _defaultValue;
+    std::string_view _environmentVariable;
+    Argument::Type _type = Argument::String;
+    bool _required = false;
+    bool _hasDefaultValue = false;
+};
+
+/**
+ * Positional argument, which takes the values that don't belong to an option.
+ *
+ * Positional arguments are assigned in order of registration, arguments taking
+ * a variable number of values take as many as possible.
+ */
+struct Positional final
+{
+public:
+    enum Arity
+    {
+        One,        /// exactly one value (`1`), missing when there is none
+        Optional,   /// zero or one value (`?`)
+        Any,        /// any number of values (`*`)
+        AtLeastOne, /// one or more values (`+`), missing when there is none
+    };
+
+    explicit Positional(const std::string &name, const std::string &description, Arity arity = One)
+        :
+        _name(name),
+        _description(description),
+        _arity(arity)
+    {
+    }
+
+    inline const auto &name() const
+    {
+        return this->_name;
+    }
+
+    inline const auto &description() const
+    {
+        return this->_description;
+    }
+
+    inline Arity arity() const
+    {
+        return this->_arity;
+    }
+
+    /**
+     * minimum number of values
+     */
+    inline std::size_t minimum() const
+    {
+        return this->_arity == One || this->_arity == AtLeastOne ? 1 : 0;
+    }
+
+    /**
+     * maximum number of values
+     */
+    inline std::size_t maximum() const
+    {
+        return this->_arity == One || this->_arity == Optional ? 1 : static_cast<std::size_t>(-1);
+    }
+
+private:
+    std::string _name;
+    std::string _description;
+    Arity _arity = One;
 };
 
+inline ArgumentDefinition Argument::definition() const
+{
+    if (this->hasDefaultValue())
+    {
+        return ArgumentDefinition(this->_shortName, this->_longName, this->_description, this->_defaultValue.value(), this->_type, this->_required)
+            .withEnvironmentVariable(this->_environmentVariable);
+    }
+    return ArgumentDefinition(this->_shortName, this->_longName, this->_description, this->_type, this->_required)
+        .withEnvironmentVariable(this->_environmentVariable);
+}
+
 } // namespace argparse
 
 #endif // LIBARGPARSE_ARGUMENT_HPP
@@ -0,0 +1,33 @@
+#include "batch.hpp"
+
+#include "internal/work_stealing.hpp"
+
+#include <thread>
+
+std::vector<argparse::ParsedArguments> argparse::parseBatch(
+    const ArgumentSchema &schema, const std::vector<CommandLine> &commandLines, unsigned threads)
+{
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    // every index is written by exactly one thread
+    std::vector<ParsedArguments> results(commandLines.size());
+    argparse::parallel_for(commandLines.size(), threads, [&](std::size_t i) {
+        results[i] = schema.parse(commandLines[i]);
+    });
+    return results;
+}
+
+std::vector<argparse::ParsedArguments> argparse::parseBatch(
+    const ArgumentSchema &schema, const std::vector<std::vector<std::string>> &commandLines, unsigned threads)
+{
+    std::vector<CommandLine> views;
+    views.reserve(commandLines.size());
+    for (auto &&args : commandLines)
+    {
+        views.emplace_back(args);
+    }
+    return argparse::parseBatch(schema, views, threads);
+}
@@ -0,0 +1,33 @@
+#ifndef LIBARGPARSE_BATCH_HPP
+#define LIBARGPARSE_BATCH_HPP
+
+#include "schema.hpp"
+
+#include <vector>
+#include <string>
+
+namespace argparse {
+
+/**
+ * Parses all given command lines against the same schema in parallel.
+ *
+ * The results are returned in input order and reference the schema
+ * and the given command lines. Use `ParsedArguments::result()` to get
+ * the status of each command line.
+ *
+ * When `threads` is zero, all available cores are used.
+ */
+std::vector<ParsedArguments> parseBatch(
+    const ArgumentSchema &schema, const std::vector<CommandLine> &commandLines, unsigned threads = 0);
+
+/**
+ * Parses all given command lines against the same schema in parallel.
+ *
+ * See above for details.
+ */
+std::vector<ParsedArguments> parseBatch(
+    const ArgumentSchema &schema, const std::vector<std::vector<std::string>> &commandLines, unsigned threads = 0);
+
+} // namespace argparse
+
+#endif // LIBARGPARSE_BATCH_HPP
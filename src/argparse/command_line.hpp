@@ -0,0 +1,110 @@
+#ifndef LIBARGPARSE_COMMAND_LINE_HPP
+#define LIBARGPARSE_COMMAND_LINE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory_resource>
+#include <cstring>
+#include <cstddef>
+
+namespace argparse {
+
+/**
+ * Read-only view over command line arguments.
+ *
+ * The view doesn't copy anything, the viewed strings must outlive
+ * the CommandLine and everything which was parsed from it.
+ */
+struct CommandLine final
+{
+public:
+    /**
+     * View the arguments of the `main()` function.
+     */
+    explicit CommandLine(int argc, const char *const *argv)
+        : _argv(argv),
+          _size(argc > 0 && argv ? static_cast<std::size_t>(argc) : 0)
+    {
+    }
+
+    /**
+     * View the strings of the given vector.
+     */
+    explicit CommandLine(const std::vector<std::string> &args)
+        : _strings(args.data()),
+          _size(args.size())
+    {
+    }
+
+    /**
+     * View the strings of the given list, like the remaining arguments of a parse.
+     */
+    explicit CommandLine(const std::pmr::vector<std::pmr::string> &args)
+        : _pmrStrings(args.data()),
+          _size(args.size())
+    {
+    }
+
+    /**
+     * View the strings the given views point to.
+     */
+    template<typename Allocator>
+    explicit CommandLine(const std::vector<std::string_view, Allocator> &args)
+        : _views(args.data()),
+          _size(args.size())
+    {
+    }
+
+    inline std::size_t size() const
+    {
+        return this->_size;
+    }
+
+    /**
+     * View of the arguments starting at the given position.
+     */
+    inline CommandLine subview(std::size_t offset) const
+    {
+        offset = offset < this->_size ? offset : this->_size;
+
+        CommandLine view = *this;
+        if (this->_strings) view._strings += offset;
+        if (this->_views) view._views += offset;
+        if (this->_pmrStrings) view._pmrStrings += offset;
+        if (this->_argv) view._argv += offset;
+        view._size -= offset;
+        return view;
+    }
+
+    /**
+     * returns the argument at the given position, no bounds checking is done
+     */
+    inline std::string_view operator[](std::size_t i) const
+    {
+        if (this->_strings)
+        {
+            return this->_strings[i];
+        }
+        else if (this->_views)
+        {
+            return this->_views[i];
+        }
+        else if (this->_pmrStrings)
+        {
+            return this->_pmrStrings[i];
+        }
+        return std::string_view(this->_argv[i], std::strlen(this->_argv[i]));
+    }
+
+private:
+    const std::string *_strings = nullptr;
+    const std::string_view *_views = nullptr;
+    const std::pmr::string *_pmrStrings = nullptr;
+    const char *const *_argv = nullptr;
+    std::size_t _size = 0;
+};
+
+} // namespace argparse
+
+#endif // LIBARGPARSE_COMMAND_LINE_HPP
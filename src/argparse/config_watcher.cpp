@@ -0,0 +1,254 @@
+#include "config_watcher.hpp"
+
+#include "internal/response_file.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <cerrno>
+
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+
+using namespace argparse;
+
+namespace {
+
+// FNV-1a of the file content
+static std::uint64_t hash_content(const MappedFile *file)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (auto i = 0u; file && i < file->size(); ++i)
+    {
+        hash = (hash ^ static_cast<unsigned char>(file->data()[i])) * 1099511628211ull;
+    }
+    return hash;
+}
+
+} // anonymous namespace
+
+argparse::ConfigWatcher::ConfigWatcher(
+    const ArgumentSchema &schema, const CommandLine &commandLine, const std::string &configFile, ChangeHandler changed)
+    : schema(schema),
+      commandLine(commandLine),
+      configFile(configFile),
+      changed(std::move(changed))
+{
+    // fall back to a regular parse which reports the error
+    if (!this->load(true))
+    {
+        this->publish(std::make_shared<const ParsedArguments>(schema.parse(commandLine, configFile)));
+    }
+}
+
+argparse::ConfigWatcher::~ConfigWatcher()
+{
+    this->stop();
+    delete this->_current.load();
+}
+
+std::shared_ptr<const argparse::ParsedArguments> argparse::ConfigWatcher::current() const
+{
+    this->readers.fetch_add(1);
+    Snapshot snapshot = *this->_current.load();
+    this->readers.fetch_sub(1);
+    return snapshot;
+}
+
+// a reader which isn't counted yet when no reader is seen loads the new pointer,
+// all operations are sequentially consistent, so the retired snapshots can be freed
+void argparse::ConfigWatcher::publish(std::shared_ptr<const ParsedArguments> result)
+{
+    const auto previous = this->_current.exchange(new Snapshot(std::move(result)));
+    if (previous)
+    {
+        this->retired.emplace_back(previous);
+    }
+
+    if (this->readers.load() == 0)
+    {
+        this->retired.clear();
+    }
+}
+
+bool argparse::ConfigWatcher::reload()
+{
+    return this->load(false);
+}
+
+// the file is copied instead of mapped, results which readers still hold
+// must not change when the file is rewritten in place
+bool argparse::ConfigWatcher::load(bool initial)
+{
+    std::vector<std::string_view> changes;
+    std::shared_ptr<const ParsedArguments> next;
+
+    {
+        std::lock_guard<std::mutex> lock(this->reloadMutex);
+
+        ParsedArguments::ResponseFiles files;
+        const MappedFile *file = nullptr;
+        if (!argparse::copy_file(this->configFile, files, file))
+        {
+            return false;
+        }
+
+        // editors write files in several steps, only parse when the content differs
+        const auto hash = hash_content(file);
+        if (!initial && hash == this->hash)
+        {
+            return false;
+        }
+
+        const std::shared_ptr<const MappedFile> content = file ? files.back() : nullptr;
+        next = std::make_shared<const ParsedArguments>(
+            this->schema.parseCommandLine(this->commandLine, &this->configFile, &content, std::pmr::get_default_resource()));
+        if (!initial && next->result() != ArgumentParserResult::Success)
+        {
+            return false; // keep the current result, a fixed file is parsed again
+        }
+        this->hash = hash;
+
+        if (initial)
+        {
+            this->publish(std::move(next));
+            return true;
+        }
+
+        changes = next->changes(**this->_current.load());
+        this->publish(next);
+    }
+
+    // the handler may reload again or read the watcher, the lock isn't held anymore
+    if (!changes.empty() && this->changed)
+    {
+        this->changed(changes, next);
+    }
+    return !changes.empty();
+}
+
+bool argparse::ConfigWatcher::start()
+{
+    if (this->running())
+    {
+        return true;
+    }
+
+    // the thread was stopped by the change handler, it can't be joined from itself
+    if (this->thread.joinable())
+    {
+        if (std::this_thread::get_id() == this->thread.get_id())
+        {
+            return false;
+        }
+        this->stop();
+    }
+
+    const std::filesystem::path path(this->configFile);
+    const auto directory = path.has_parent_path() ? path.parent_path().string() : std::string(".");
+
+    const int inotify = ::inotify_init1(IN_CLOEXEC);
+    if (inotify < 0)
+    {
+        return false;
+    }
+
+    // watch the directory, editors and deployment tools replace the file by renaming
+    if (::inotify_add_watch(inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        ::close(inotify);
+        return false;
+    }
+
+    this->stopEvent = ::eventfd(0, EFD_CLOEXEC);
+    if (this->stopEvent < 0)
+    {
+        ::close(inotify);
+        return false;
+    }
+
+    this->thread = std::thread(&ConfigWatcher::watch, this, inotify);
+    return true;
+}
+
+void argparse::ConfigWatcher::stop()
+{
+    if (!this->thread.joinable())
+    {
+        return;
+    }
+
+    this->stopping = true;
+    const std::uint64_t one = 1;
+    while (::write(this->stopEvent, &one, sizeof(one)) < 0 && errno == EINTR)
+    {
+    }
+
+    // called from the change handler, the thread ends once the handler returns
+    // and is joined by the next `start()`, `stop()` or the destructor
+    if (std::this_thread::get_id() == this->thread.get_id())
+    {
+        return;
+    }
+
+    this->thread.join();
+    ::close(this->stopEvent);
+    this->stopEvent = -1;
+    this->stopping = false;
+}
+
+void argparse::ConfigWatcher::watch(int inotify)
+{
+    const auto name = std::filesystem::path(this->configFile).filename().string();
+
+    pollfd fds[2] = {{inotify, POLLIN, 0}, {this->stopEvent, POLLIN, 0}};
+    alignas(inotify_event) char buffer[4096];
+
+    while (true)
+    {
+        if (::poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        if (fds[1].revents != 0)
+        {
+            break;
+        }
+
+        const auto count = ::read(inotify, buffer, sizeof(buffer));
+        if (count <= 0)
+        {
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        // reload once per read, even when the file was touched multiple times
+        bool touched = false;
+        for (auto offset = 0l; offset < count;)
+        {
+            const auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            // events lost to an overflow of the queue may have touched the file
+            if ((event->mask & IN_Q_OVERFLOW) || (event->len > 0 && name == event->name))
+            {
+                touched = true;
+            }
+            offset += static_cast<long>(sizeof(inotify_event) + event->len);
+        }
+
+        if (touched)
+        {
+            this->reload();
+        }
+    }
+
+    ::close(inotify);
+}
@@ -0,0 +1,115 @@
+#ifndef LIBARGPARSE_CONFIG_WATCHER_HPP
+#define LIBARGPARSE_CONFIG_WATCHER_HPP
+
+#include "schema.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+
+namespace argparse {
+
+/**
+ * Parses a command line with a config file as fallback and parses it again
+ * whenever the config file changes, for daemons which reload their configuration
+ * at runtime instead of on restart.
+ *
+ * The current result is swapped atomically, readers get a snapshot through
+ * `current()` which stays valid as long as they hold it. Reading takes no lock,
+ * replaced results are freed by a later reload once no reader copies them anymore.
+ * The schema and the command line must outlive the watcher.
+ *
+ * Only available on Linux, the build defines `LIBARGPARSE_HAS_CONFIG_WATCHER` when
+ * it is enabled with the `ARGPARSE_CONFIG_WATCHER` CMake option.
+ */
+struct ConfigWatcher final
+{
+public:
+    // the names of the arguments whose values changed and the new result
+    using ChangeHandler = std::function<void(const std::vector<std::string_view> &changed,
+                                             const std::shared_ptr<const ParsedArguments> &current)>;
+
+    /**
+     * Parses the command line with the config file, see `ArgumentSchema::parse()`.
+     * The handler is called by every reload which changes the values of arguments,
+     * without holding a lock of the watcher, so it may call `reload()` itself.
+     */
+    ConfigWatcher(const ArgumentSchema &schema, const CommandLine &commandLine, const std::string &configFile,
+                  ChangeHandler changed = {});
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher &) = delete;
+    ConfigWatcher &operator=(const ConfigWatcher &) = delete;
+
+    /**
+     * Snapshot of the latest result.
+     */
+    std::shared_ptr<const ParsedArguments> current() const;
+
+    /**
+     * Parses again if the content of the config file changed since the last parse,
+     * for example on `SIGHUP`. Files which can't be read or parsed keep the current
+     * result. Returns true if values of arguments changed.
+     */
+    bool reload();
+
+    /**
+     * Watches the directory of the config file with inotify on a background thread
+     * and reloads when the file is written or replaced. Returns false if the
+     * watch can't be set up.
+     */
+    bool start();
+
+    /**
+     * Stops watching, a running reload is finished first. The change handler may
+     * call it too, the thread then ends once the handler returns. The watcher must
+     * not be destroyed by the handler.
+     */
+    void stop();
+
+    inline bool running() const
+    {
+        return this->thread.joinable() && !this->stopping;
+    }
+
+private:
+    // parses the config file if its content changed, the initial load always parses
+    bool load(bool initial);
+
+    // replaces the current result, only called with the reload lock held
+    void publish(std::shared_ptr<const ParsedArguments> result);
+    void watch(int inotify);
+
+    const ArgumentSchema &schema;
+    const CommandLine commandLine;
+    const std::string configFile;
+    const ChangeHandler changed;
+
+    using Snapshot = std::shared_ptr<const ParsedArguments>;
+
+    // readers copy the snapshot out of the published pointer while they are counted
+    // in `readers`, a replaced snapshot is retired until no reader is active
+    std::atomic<const Snapshot*> _current{nullptr};
+    mutable std::atomic<unsigned> readers{0};
+    std::vector<std::unique_ptr<const Snapshot>> retired;
+
+    // serializes reloads, readers don't take it
+    std::mutex reloadMutex;
+
+    // content hash of the config file of the current result
+    std::uint64_t hash = 0;
+
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+    int stopEvent = -1;
+};
+
+} // namespace argparse
+
+#endif // LIBARGPARSE_CONFIG_WATCHER_HPP
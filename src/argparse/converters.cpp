@@ -0,0 +1,229 @@
+#include "converters.hpp"
+#include "internal/platform.hpp"
+
+#include <cmath>
+#include <cerrno>
+#include <string>
+
+#if LIBARGPARSE_POSIX
+#include <arpa/inet.h>
+#else
+#include <ws2tcpip.h>
+#endif
+
+// libstdc++ before GCC 11 and libc++ have no floating point `std::from_chars()`
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define LIBARGPARSE_FLOATING_FROM_CHARS 1
+#else
+#define LIBARGPARSE_FLOATING_FROM_CHARS 0
+#include <clocale>
+#include <cstdlib>
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+#endif
+
+namespace {
+
+#if LIBARGPARSE_FLOATING_FROM_CHARS
+
+template<typename T>
+static std::from_chars_result parse_floating(const char *first, const char *last, T &value, bool fixed)
+{
+    return std::from_chars(first, last, value, fixed ? std::chars_format::fixed : std::chars_format::general);
+}
+
+#else
+
+#if LIBARGPARSE_POSIX
+static locale_t c_locale()
+{
+    static const locale_t locale = ::newlocale(LC_ALL_MASK, "C", nullptr);
+    return locale;
+}
+
+static void strto(const char *string, char **end, float &value)       { value = ::strtof_l(string, end, c_locale()); }
+static void strto(const char *string, char **end, double &value)      { value = ::strtod_l(string, end, c_locale()); }
+static void strto(const char *string, char **end, long double &value) { value = ::strtold_l(string, end, c_locale()); }
+#else
+static _locale_t c_locale()
+{
+    static const _locale_t locale = ::_create_locale(LC_ALL, "C");
+    return locale;
+}
+
+static void strto(const char *string, char **end, float &value)       { value = ::_strtof_l(string, end, c_locale()); }
+static void strto(const char *string, char **end, double &value)      { value = ::_strtod_l(string, end, c_locale()); }
+static void strto(const char *string, char **end, long double &value) { value = ::_strtold_l(string, end, c_locale()); }
+#endif
+
+static bool is_fixed_char(char c)
+{
+    return (c >= '0' && c <= '9') || c == '.';
+}
+
+// `strtod()` needs a terminated string and takes more than `std::from_chars()`, leading
+// whitespace, a plus sign and hexadecimal numbers are rejected before calling it
+template<typename T>
+static std::from_chars_result parse_floating(const char *first, const char *last, T &value, bool fixed)
+{
+    const char *number = first != last && *first == '-' ? first + 1 : first;
+    if (number == last || *number == '+' || *first == ' ' || (*first >= '\t' && *first <= '\r'))
+    {
+        return {first, std::errc::invalid_argument};
+    }
+
+    const char *end = last;
+    if (fixed)
+    {
+        end = std::find_if_not(number, last, is_fixed_char);
+    }
+    else if (last - number > 1 && number[0] == '0' && (number[1] == 'x' || number[1] == 'X'))
+    {
+        end = number + 1; // `std::from_chars()` stops after the zero
+    }
+
+    const std::string terminated(first, end);
+    char *parsedEnd = nullptr;
+    T parsed{};
+    errno = 0;
+    strto(terminated.c_str(), &parsedEnd, parsed);
+
+    const char *ptr = first + (parsedEnd - terminated.c_str());
+    if (ptr == first)
+    {
+        return {first, std::errc::invalid_argument};
+    }
+    else if (errno == ERANGE)
+    {
+        return {ptr, std::errc::result_out_of_range};
+    }
+
+    value = parsed;
+    return {ptr, std::errc()};
+}
+
+#endif
+
+} // anonymous namespace
+
+std::from_chars_result argparse::from_chars_floating(const char *first, const char *last, float &value, bool fixed)
+{
+    return parse_floating(first, last, value, fixed);
+}
+
+std::from_chars_result argparse::from_chars_floating(const char *first, const char *last, double &value, bool fixed)
+{
+    return parse_floating(first, last, value, fixed);
+}
+
+std::from_chars_result argparse::from_chars_floating(const char *first, const char *last, long double &value, bool fixed)
+{
+    return parse_floating(first, last, value, fixed);
+}
+
+std::optional<argparse::ByteSize> argparse::converter<argparse::ByteSize>::convert(std::string_view value)
+{
+    double count = 0;
+    const char *const end = value.data() + value.size();
+    const auto res = argparse::from_chars_floating(value.data(), end, count, true);
+    if (res.ec != std::errc() || value.empty() || value[0] == '-' || value[0] == '+')
+    {
+        return std::nullopt;
+    }
+
+    auto suffix = std::string_view(res.ptr, static_cast<std::size_t>(end - res.ptr));
+
+    unsigned shift = 0;
+    if (!suffix.empty())
+    {
+        switch (suffix[0] & ~0x20) // ASCII upper case
+        {
+            case 'K': shift = 10; break;
+            case 'M': shift = 20; break;
+            case 'G': shift = 30; break;
+            case 'T': shift = 40; break;
+            case 'P': shift = 50; break;
+            case 'E': shift = 60; break;
+            case 'B': break;
+            default: return std::nullopt;
+        }
+
+        if (shift != 0)
+        {
+            suffix.remove_prefix(1);
+        }
+        if (suffix == "iB" || suffix == "B")
+        {
+            suffix = {};
+        }
+        if (!suffix.empty())
+        {
+            return std::nullopt;
+        }
+    }
+
+    const auto bytes = std::floor(std::ldexp(count, static_cast<int>(shift)));
+    if (!(bytes < 18446744073709551616.0)) // 2^64, rejects NaN too
+    {
+        return std::nullopt;
+    }
+
+    return ByteSize(static_cast<std::uint64_t>(bytes));
+}
+
+std::optional<argparse::IPAddress> argparse::converter<argparse::IPAddress>::convert(std::string_view value)
+{
+    std::array<std::uint8_t, 16> bytes = {};
+
+    // dotted decimal IPv4, four numbers up to 255 without leading zeros
+    if (value.find(':') == std::string_view::npos)
+    {
+        const char *read = value.data();
+        const char *const end = value.data() + value.size();
+
+        for (auto i = 0u; i < 4; ++i)
+        {
+            if (i > 0)
+            {
+                if (read == end || *read != '.')
+                {
+                    return std::nullopt;
+                }
+                ++read;
+            }
+
+            unsigned octet = 0;
+            const auto res = std::from_chars(read, end, octet);
+            if (res.ec != std::errc() || octet > 255 || (res.ptr - read > 1 && *read == '0'))
+            {
+                return std::nullopt;
+            }
+            bytes[i] = static_cast<std::uint8_t>(octet);
+            read = res.ptr;
+        }
+
+        return read == end ? std::optional<IPAddress>(IPAddress(IPAddress::V4, bytes)) : std::nullopt;
+    }
+
+    // `inet_pton()` needs a terminated string
+    char address[INET6_ADDRSTRLEN] = {};
+    if (value.size() >= sizeof(address))
+    {
+        return std::nullopt;
+    }
+    value.copy(address, value.size());
+
+    if (::inet_pton(AF_INET6, address, bytes.data()) != 1)
+    {
+        return std::nullopt;
+    }
+    return IPAddress(IPAddress::V6, bytes);
+}
+
+std::string argparse::IPAddress::toString() const
+{
+    char address[INET6_ADDRSTRLEN] = {};
+    ::inet_ntop(this->_family == V4 ? AF_INET : AF_INET6, this->_bytes.data(), address, sizeof(address));
+    return address;
+}
@@ -0,0 +1,316 @@
+#ifndef LIBARGPARSE_CONVERTERS_HPP
+#define LIBARGPARSE_CONVERTERS_HPP
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <charconv>
+#include <cstdint>
+#include <cstddef>
+
+namespace argparse {
+
+/**
+ * Parses a floating point number like `std::from_chars()`, which isn't available for
+ * floating point types in every standard library. Those fall back to `strtod_l()` and
+ * its siblings with the C locale. Without `fixed` the general format is parsed, with
+ * it the number has no exponent.
+ */
+std::from_chars_result from_chars_floating(const char *first, const char *last, float &value, bool fixed = false);
+std::from_chars_result from_chars_floating(const char *first, const char *last, double &value, bool fixed = false);
+std::from_chars_result from_chars_floating(const char *first, const char *last, long double &value, bool fixed = false);
+
+/**
+ * Converts argument values to `T`, every typed read like `get<T>()`, `getAll<T>()`,
+ * `positional<T>()` and bindings dispatches to it at compile time.
+ *
+ * Specialize it for own types with a static `convert()` function, which returns
+ * `std::nullopt` for values which can't be converted:
+ *
+ *     template<>
+ *     struct argparse::converter<Color>
+ *     {
+ *         static std::optional<Color> convert(std::string_view value);
+ *     };
+ *
+ * The primary template supports `std::string`, `std::string_view`, `bool`
+ * and all integral and floating point types.
+ */
+template<typename T, typename Enable = void>
+struct converter
+{
+    static std::optional<T> convert(std::string_view value)
+    {
+        // check string first, as this may be the most required usage
+        if constexpr (std::is_same_v<T, std::string>)
+        {
+            return std::string(value);
+        }
+        // views into the parsed command line, without copying
+        else if constexpr (std::is_same_v<T, std::string_view>)
+        {
+            return value;
+        }
+        // check boolean before integral types, because bool is an integral type too
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            if (value == "true")
+            {
+                return true;
+            }
+            else if (value == "false")
+            {
+                return false;
+            }
+            else
+            {
+                return std::nullopt;
+            }
+        }
+        // check all integral and floating point types, the whole value must be a number,
+        // floating point numbers always use `.` as decimal separator regardless of the locale
+        else if constexpr (std::is_integral_v<T> || std::is_floating_point_v<T>)
+        {
+            T parsed{};
+            const char* end = value.data() + value.size();
+            std::from_chars_result res;
+            if constexpr (std::is_integral_v<T>)
+            {
+                res = std::from_chars(value.data(), end, parsed);
+            }
+            else
+            {
+                res = argparse::from_chars_floating(value.data(), end, parsed);
+            }
+
+            if (!static_cast<bool>(res.ec) && res.ptr == end)
+            {
+                return parsed;
+            }
+            else
+            {
+                return std::nullopt;
+            }
+        }
+        // unsupported input
+        else
+        {
+            return std::nullopt;
+        }
+    }
+};
+
+/**
+ * Durations like `250ms`, `90s` or `1h30m`, one or more integers with the units
+ * `ns`, `us`, `ms`, `s`, `m`, `h` and `d`. A single integer without unit counts
+ * in the period of the duration. Values are summed up in nanoseconds and cast to
+ * the duration afterwards, `1m30s` as `std::chrono::minutes` is one minute.
+ */
+template<typename Rep, typename Period>
+struct converter<std::chrono::duration<Rep, Period>>
+{
+    using Duration = std::chrono::duration<Rep, Period>;
+
+    static std::optional<Duration> convert(std::string_view value)
+    {
+        const bool negative = !value.empty() && value[0] == '-';
+        if (negative)
+        {
+            value.remove_prefix(1);
+        }
+
+        std::uint64_t count = 0;
+        const char *read = value.data();
+        const char *const end = value.data() + value.size();
+
+        // plain number in the period of the duration
+        auto res = std::from_chars(read, end, count);
+        if (res.ec != std::errc())
+        {
+            return std::nullopt;
+        }
+        else if (res.ptr == end)
+        {
+            if (count > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()))
+            {
+                return std::nullopt;
+            }
+            const auto signedCount = static_cast<std::int64_t>(count);
+            return std::chrono::duration_cast<Duration>(
+                std::chrono::duration<std::int64_t, Period>(negative ? -signedCount : signedCount));
+        }
+
+        constexpr std::uint64_t max = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+        std::uint64_t total = 0;
+
+        while (true)
+        {
+            read = res.ptr;
+            const auto unitEnd = std::find_if(read, end, [](char c) { return c >= '0' && c <= '9'; });
+            const auto nanoseconds = unit(std::string_view(read, static_cast<std::size_t>(unitEnd - read)));
+            if (nanoseconds == 0 || count > (max - total) / nanoseconds)
+            {
+                return std::nullopt;
+            }
+            total += count * nanoseconds;
+
+            if (unitEnd == end)
+            {
+                break;
+            }
+
+            res = std::from_chars(unitEnd, end, count);
+            if (res.ec != std::errc() || res.ptr == end)
+            {
+                return std::nullopt; // a number without unit
+            }
+        }
+
+        const auto signedTotal = static_cast<std::int64_t>(total);
+        return std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(negative ? -signedTotal : signedTotal));
+    }
+
+private:
+    // nanoseconds of the given unit, zero for unknown units
+    static constexpr std::uint64_t unit(std::string_view name)
+    {
+        if (name == "ns") return 1;
+        if (name == "us") return 1000;
+        if (name == "ms") return 1000 * 1000;
+        if (name == "s")  return 1000 * 1000 * 1000;
+        if (name == "m")  return 60ull * 1000 * 1000 * 1000;
+        if (name == "h")  return 60ull * 60 * 1000 * 1000 * 1000;
+        if (name == "d")  return 24ull * 60 * 60 * 1000 * 1000 * 1000;
+        return 0;
+    }
+};
+
+/**
+ * Number of bytes, converted from sizes like `512`, `64K` or `1.5G`.
+ */
+struct ByteSize final
+{
+public:
+    constexpr ByteSize() = default;
+
+    constexpr explicit ByteSize(std::uint64_t bytes)
+        : _bytes(bytes)
+    {
+    }
+
+    constexpr std::uint64_t bytes() const
+    {
+        return this->_bytes;
+    }
+
+    constexpr bool operator==(const ByteSize &other) const
+    {
+        return this->_bytes == other._bytes;
+    }
+
+    constexpr bool operator!=(const ByteSize &other) const
+    {
+        return this->_bytes != other._bytes;
+    }
+
+private:
+    std::uint64_t _bytes = 0;
+};
+
+/**
+ * Byte sizes with an optional binary suffix `K`, `M`, `G`, `T`, `P` or `E`, which may be
+ * followed by `B` or `iB` (`64K`, `64KB` and `64KiB` are 65536 bytes). The number may have
+ * a fraction (`1.5G`), the result is rounded down to whole bytes.
+ */
+template<>
+struct converter<ByteSize>
+{
+    static std::optional<ByteSize> convert(std::string_view value);
+};
+
+/**
+ * IPv4 or IPv6 address in network byte order.
+ */
+struct IPAddress final
+{
+public:
+    enum Family : std::uint8_t
+    {
+        V4,
+        V6,
+    };
+
+    constexpr IPAddress() = default;
+
+    constexpr IPAddress(Family family, const std::array<std::uint8_t, 16> &bytes)
+        : _bytes(bytes),
+          _family(family)
+    {
+    }
+
+    constexpr Family family() const
+    {
+        return this->_family;
+    }
+
+    /**
+     * The address bytes, only the first 4 are used for IPv4 addresses.
+     */
+    constexpr const std::array<std::uint8_t, 16> &bytes() const
+    {
+        return this->_bytes;
+    }
+
+    constexpr std::size_t size() const
+    {
+        return this->_family == V4 ? 4 : 16;
+    }
+
+    /**
+     * Formats the address in its canonical text form.
+     */
+    std::string toString() const;
+
+    constexpr bool operator==(const IPAddress &other) const
+    {
+        return this->_family == other._family && this->_bytes == other._bytes;
+    }
+
+    constexpr bool operator!=(const IPAddress &other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    std::array<std::uint8_t, 16> _bytes = {};
+    Family _family = V4;
+};
+
+/**
+ * Dotted decimal IPv4 addresses and IPv6 addresses in any of their text forms.
+ * IPv4 addresses are parsed inline, IPv6 addresses with `inet_pton()`.
+ */
+template<>
+struct converter<IPAddress>
+{
+    static std::optional<IPAddress> convert(std::string_view value);
+};
+
+template<>
+struct converter<std::filesystem::path>
+{
+    static std::optional<std::filesystem::path> convert(std::string_view value)
+    {
+        return std::filesystem::path(value);
+    }
+};
+
+} // namespace argparse
+
+#endif // LIBARGPARSE_CONVERTERS_HPP
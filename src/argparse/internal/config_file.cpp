@@ -0,0 +1,97 @@
+#include "config_file.hpp"
+#include "response_file.hpp"
+
+#include <cstring>
+
+using namespace argparse;
+
+using Res = ArgumentParserResult;
+
+namespace {
+
+static bool is_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static std::string_view trim(const char *begin, const char *end)
+{
+    while (begin < end && is_blank(*begin))
+    {
+        ++begin;
+    }
+    while (end > begin && is_blank(end[-1]))
+    {
+        --end;
+    }
+    return std::string_view(begin, static_cast<std::size_t>(end - begin));
+}
+
+static std::string_view unquote(std::string_view value)
+{
+    if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front())
+    {
+        return value.substr(1, value.size() - 2);
+    }
+    return value;
+}
+
+} // anonymous namespace
+
+// a single pass over the content, every line is split with `memchr()`
+// and the keys and values are views, nothing is copied
+argparse::ArgumentParserResult argparse::tokenize_config(
+    const ArgumentSchema &schema, const char *data, std::size_t size, ConfigValues &values)
+{
+    const char *read = data;
+    const char *const end = data + size;
+
+    while (read < end)
+    {
+        auto lineEnd = static_cast<const char*>(std::memchr(read, '\n', static_cast<std::size_t>(end - read)));
+        if (!lineEnd)
+        {
+            lineEnd = end;
+        }
+
+        const auto line = trim(read, lineEnd);
+        // the last line may not end with a newline, don't step past the end
+        read = lineEnd < end ? lineEnd + 1 : end;
+
+        if (line.empty() || line[0] == '#' || line[0] == ';' || line[0] == '[')
+        {
+            continue;
+        }
+
+        const auto separator = line.find('=');
+        if (separator == std::string_view::npos)
+        {
+            return Res::ConfigFileError;
+        }
+
+        const auto key = trim(line.data(), line.data() + separator);
+        const auto position = schema.findLongName(key);
+        if (position == ArgumentSchema::npos)
+        {
+            continue;
+        }
+
+        values.emplace_back(static_cast<std::uint32_t>(position),
+            unquote(trim(line.data() + separator + 1, line.data() + line.size())));
+    }
+
+    return Res::Success;
+}
+
+argparse::ArgumentParserResult argparse::read_config_file(
+    const ArgumentSchema &schema, const std::string &path,
+    ConfigValues &values, ParsedArguments::ResponseFiles &files)
+{
+    const MappedFile *file = nullptr;
+    if (!argparse::map_file(path, files, file))
+    {
+        return Res::ConfigFileError;
+    }
+
+    return file ? argparse::tokenize_config(schema, file->data(), file->size(), values) : Res::Success;
+}
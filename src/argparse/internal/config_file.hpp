@@ -0,0 +1,34 @@
+#pragma once
+
+#include <argparse/schema.hpp>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace argparse {
+
+// values of a config file by argument position in file order
+using ConfigValues = std::pmr::vector<std::pair<std::uint32_t, std::string_view>>;
+
+/**
+ * Splits the content of a config file into values, see below.
+ */
+ArgumentParserResult tokenize_config(const ArgumentSchema &schema, const char *data, std::size_t size, ConfigValues &values);
+
+/**
+ * Reads a `key = value` config file. Keys are long option names without the prefix,
+ * lines starting with `#` or `;` are comments and `[section]` headers are skipped.
+ * Whitespace around keys and values and one pair of quotes around a value are removed.
+ * Keys which aren't arguments of the schema are ignored.
+ *
+ * The file is mapped and appended to `files`, the values are views into the mapping.
+ * Returns `ConfigFileError` if the file can't be read or has a line without `=`.
+ */
+ArgumentParserResult read_config_file(
+    const ArgumentSchema &schema, const std::string &path,
+    ConfigValues &values, ParsedArguments::ResponseFiles &files);
+
+} // namespace argparse
@@ -1,31 +1,37 @@
 #include "parser.hpp"
+#include "platform.hpp"
 
 #include <string>
+#include <string_view>
 #include <optional>
+#include <algorithm>
+#include <cstdlib>
+
+#if LIBARGPARSE_POSIX
+#include <unistd.h>
+
+// not declared by every libc
+extern char **environ;
+#endif
 
 using namespace argparse;
 
-using Arguments = ArgumentParser::Arguments;
+using Definitions = ArgumentSchema::Definitions;
+using Slots = ParsedArguments::Slots;
 
 namespace {
 
-std::string shortOptionPrefix;
-std::string longOptionPrefix;
-
-enum class OptionType
+static bool starts_with(std::string_view str, std::string_view prefix)
 {
-    Short,
-    Long,
-    Value,
-    Unknown,
-};
+    return str.size() >= prefix.size() && str.compare(0, prefix.size(), prefix) == 0;
+}
 
-// check registered arguments for required ones
-static bool has_required_arguments(Arguments &registeredArguments)
+// check registered arguments for required ones which are still missing
+static bool has_required_arguments(const Definitions &definitions, const Slots &slots)
 {
-    for (auto&& arg : registeredArguments)
+    for (auto i = 0u; i < definitions.size(); ++i)
     {
-        if (arg.required())
+        if (definitions[i].required() && !slots[i].present)
         {
             return true;
         }
@@ -34,196 +40,548 @@ static bool has_required_arguments(Arguments &registeredArguments)
     return false;
 }
 
-// is the option a long option
-static bool is_long_option(const std::string &option)
+// boolean switches are enabled by any value but an empty one, `0` and `false`
+static bool is_enabled(std::string_view value)
 {
-    return
-        option.size() >= longOptionPrefix.size() &&
-        option.substr(0, longOptionPrefix.size()) == longOptionPrefix;
+    return !value.empty() && value != "0" && value != "false";
 }
 
-// is the option a short option
-static bool is_short_option(const std::string &option)
+} // anonymous namespace
+
+// all state lives in the matcher, nothing is shared between invocations
+// which makes it safe to parse with multiple parser instances concurrently
+argparse::Matcher::Matcher(const ArgumentSchema &schema, ParsedArguments &parsed)
+    : schema(schema),
+      definitions(schema.definitions()),
+      positionals(schema.positionals()),
+      shortOptionPrefix(schema.shortOptionPrefix()),
+      longOptionPrefix(schema.longOptionPrefix()),
+      terminator(schema.terminator()),
+      parsed(parsed),
+      slots(parsed._slots),
+      appendedValues(parsed._appendedValues),
+      positionalValues(parsed._positionalValues),
+      positionalCache(parsed._positionalCache),
+      positionalRanges(parsed._positionalRanges),
+      missingArguments(parsed._missingArguments),
+      ambiguousArguments(parsed._ambiguousArguments),
+      loseArguments(parsed._loseArguments),
+      remainingArguments(parsed._remainingArguments),
+      ownedValues(parsed._slots.get_allocator()),
+      appended(parsed._slots.get_allocator())
 {
-    return
-        option.size() >= shortOptionPrefix.size() &&
-        option.substr(0, shortOptionPrefix.size()) == shortOptionPrefix && !is_long_option(option);
+    for (auto&& positional : this->positionals)
+    {
+        const auto maximum = positional.maximum();
+        this->positionalCapacity = maximum > ArgumentSchema::npos - this->positionalCapacity ?
+            ArgumentSchema::npos : this->positionalCapacity + maximum;
+    }
 }
 
-// is the option a value
-static bool is_value(const std::string &option)
+// classify the token and strip the option prefix, a token is an option
+// when it starts with the long or short prefix (long wins) and a value otherwise
+argparse::Matcher::Token argparse::Matcher::classify(std::string_view token) const
 {
-    return !is_short_option(option) && !is_long_option(option);
+    if (starts_with(token, this->longOptionPrefix))
+    {
+        return Token{OptionType::Long, token.substr(this->longOptionPrefix.size())};
+    }
+    else if (starts_with(token, this->shortOptionPrefix))
+    {
+        return Token{OptionType::Short, token.substr(this->shortOptionPrefix.size())};
+    }
+    return Token{OptionType::Value, token};
 }
 
-// get option type as enum
-static const OptionType get_option_type(const std::string &option)
+// resolve the option name, the names matching the option type are preferred
+std::size_t argparse::Matcher::findArgument(std::string_view name, OptionType type) const
 {
-    if (is_short_option(option))
-    { return OptionType::Short; }
-    else if (is_long_option(option))
-    { return OptionType::Long; }
-    else if (is_value(option))
-    { return OptionType::Value; }
-    else return OptionType::Unknown;
+    const auto position = type == OptionType::Short ?
+        this->schema.findShortName(name) : this->schema.findLongName(name);
+
+    if (position != ArgumentSchema::npos)
+    {
+        return position;
+    }
+
+    return type == OptionType::Short ?
+        this->schema.findLongName(name) : this->schema.findShortName(name);
 }
 
-// get option name without prefix or value
-static std::string get_option_name(const std::string &option)
+// resolve a cluster of single character short options like `-abc` or `-ofile`,
+// every option but the last must be a boolean switch, a string option ends the
+// cluster and takes the rest of the token as its value (`-ofile`, `-o=file`)
+// returns the position of the last option or npos if any character is unknown
+std::size_t argparse::Matcher::findBundle(std::string_view name, std::optional<std::string_view> &attachedValue)
 {
-    switch (get_option_type(option))
+    std::size_t position = ArgumentSchema::npos;
+    auto last = 0u;
+    for (; last < name.size(); ++last)
+    {
+        position = this->schema.findShortCharacter(name[last]);
+        if (position == ArgumentSchema::npos)
+        {
+            return ArgumentSchema::npos;
+        }
+
+        if (this->definitions[position].type() != Argument::Boolean)
+        {
+            break;
+        }
+    }
+
+    if (last + 1 < name.size())
+    {
+        const auto rest = name.substr(last + 1);
+        attachedValue = rest[0] == '=' ? rest.substr(1) : rest;
+    }
+    else
+    {
+        last = static_cast<unsigned>(name.size()) - 1;
+    }
+
+    // all options are known, mark the leading boolean switches as found
+    for (auto i = 0u; i < last; ++i)
     {
-        case OptionType::Long:    return option.substr(longOptionPrefix.size());
-        case OptionType::Short:   return option.substr(shortOptionPrefix.size());
-        case OptionType::Value:   return option;
-        case OptionType::Unknown: return option;
+        auto &slot = this->slots[this->schema.findShortCharacter(name[i])];
+        slot.present = true;
+        slot.value = "true";
     }
+
+    return position;
 }
 
-static Argument *find_argument(Arguments &registeredArguments, const std::string &name)
+void argparse::Matcher::setValue(std::size_t position, std::string_view value)
 {
-    for (auto& argument : registeredArguments)
+    const bool append = this->definitions[position].type() == Argument::Append;
+
+    // every value of an `Append` option is kept, other options only keep the last
+    // one and reuse its copy, so repeating them doesn't grow the storage
+    if (this->values && append)
+    {
+        value = this->values->emplace_back(value);
+    }
+    else if (this->values)
     {
-        if (argument.name() == name || argument.longName() == name || argument.shortName() == name)
+        auto &owned = this->ownedValues[position];
+        if (!owned)
         {
-            return &argument;
+            owned = &this->values->emplace_back();
         }
+        owned->assign(value.data(), value.size());
+        value = *owned;
     }
+    this->slots[position].value = value;
 
-    return nullptr;
+    if (append)
+    {
+        this->appended.emplace_back(static_cast<std::uint32_t>(position), value);
+    }
 }
 
-} // anonymous namespace
+void argparse::Matcher::addLoseArgument(std::string_view value)
+{
+    if (this->loseArgumentHandler)
+    {
+        (*this->loseArgumentHandler)(value);
+    }
+    else
+    {
+        this->loseArguments.emplace_back(value);
+    }
+}
 
-argparse::ArgumentParserResult argparse::parse(
-    const argparse::ArgumentParser &parserInstance,
-    const std::vector<std::string> &args, Arguments &registeredArguments,
-    const std::string &_shortOptionPrefix, const std::string &_longOptionPrefix,
-    const std::string &terminator,
-    StringList &missingArguments, StringList &loseArguments, StringList &remainingArguments)
+// assign the values to the positional arguments in order of registration, every
+// argument gets its minimum first and the remaining values go to the first arguments
+// which take more, values which no argument takes are lose arguments
+void argparse::Matcher::assignPositionals()
 {
-    using Res = ArgumentParserResult;
+    if (this->positionals.empty())
+    {
+        return;
+    }
+
+    const auto count = this->positionalValues.size();
 
-    shortOptionPrefix = _shortOptionPrefix;
-    longOptionPrefix = _longOptionPrefix;
+    std::size_t minimum = 0;
+    for (auto&& positional : this->positionals)
+    {
+        minimum += positional.minimum();
+    }
 
-    // check for required arguments
-    const bool requiredArguments = has_required_arguments(registeredArguments);
+    std::size_t extra = count > minimum ? count - minimum : 0;
+    std::size_t next = 0;
 
-    // args contains only the command and arguments are required
-    if (args.size() <= 1 && requiredArguments)
+    this->positionalRanges.resize(this->positionals.size());
+    for (auto i = 0u; i < this->positionals.size(); ++i)
     {
-        return Res::InsufficientArguments;
+        const auto &positional = this->positionals[i];
+
+        auto take = std::min(positional.minimum(), count - next);
+        const auto more = std::min(positional.maximum() - positional.minimum(), extra);
+        take += more;
+        extra -= more;
+
+        this->positionalRanges[i] = {static_cast<std::uint32_t>(next), static_cast<std::uint32_t>(take)};
+        next += take;
+
+        if (take < positional.minimum())
+        {
+            this->missingArguments.emplace_back(positional.name());
+        }
     }
-    // no args given and no required arguments
-    else if (args.size() <= 1)
+
+    for (auto i = next; i < count; ++i)
     {
-        return Res::Success;
+        this->addLoseArgument(this->positionalValues[i]);
     }
 
-    for (auto i = 1u; i < args.size(); ++i)
+    this->positionalValues.resize(next);
+    this->positionalCache.resize(next);
+}
+
+// arguments which aren't on the command line take the value of their environment
+// variable, the environment is scanned once and every name is looked up in the
+// index of the schema instead of calling `getenv()` for every argument
+void argparse::Matcher::applyEnvironment()
+{
+    if (!this->schema.hasEnvironmentVariables())
     {
-        if (terminator.size() > 0 && args.at(i) == terminator)
+        return;
+    }
+
+    const auto apply = [this](std::size_t position, std::string_view value) {
+        if (this->definitions[position].type() == Argument::Boolean)
         {
-            if ((i+1) < args.size())
+            if (is_enabled(value))
             {
-                // NOTE: in the D implemenation this is one line of code, thanks to array slicing
-                // remainingArguments = args[i+1..$];
-                const auto begin = args.cbegin() + (i+1);
-                const auto end   = args.cend();
-                for (auto it = begin; it < end; ++it)
-                {
-                    remainingArguments.emplace_back(*it);
-                }
+                this->slots[position].present = true;
+                this->slots[position].value = "true";
             }
-            break;
         }
+        else
+        {
+            this->slots[position].present = true;
+            this->setValue(position, value);
+        }
+    };
 
-        // get next option or null
-        const auto next_option = [&]() -> std::optional<std::string> {
-            if ((i+1) >= args.size())
-            {
-                return std::nullopt;
-            }
-            else
-            {
-                return args.at(i+1);
-            }
-        };
+#if LIBARGPARSE_POSIX
+    for (char **variable = environ; *variable; ++variable)
+    {
+        const std::string_view entry(*variable);
+        const auto separator = entry.find('=');
+        if (separator == std::string_view::npos)
+        {
+            continue;
+        }
 
-        const auto name = get_option_name(args.at(i));
-        const auto type = get_option_type(args.at(i));
+        const auto position = this->schema.findEnvironmentVariable(entry.substr(0, separator));
+        if (position == ArgumentSchema::npos || this->slots[position].present)
+        {
+            continue;
+        }
 
-        if (type == OptionType::Long || type == OptionType::Short)
+        apply(position, entry.substr(separator + 1));
+    }
+#else
+    // without `environ` every variable is looked up on its own
+    for (std::size_t position = 0; position < this->definitions.size(); ++position)
+    {
+        const auto name = this->definitions[position].environmentVariable();
+        if (name.empty() || this->slots[position].present)
         {
-            auto argument = find_argument(registeredArguments, name);
+            continue;
+        }
 
-            if (argument == nullptr)
-            {
-                continue;
-            }
+        if (const char *value = std::getenv(std::string(name).c_str()))
+        {
+            apply(position, value);
+        }
+    }
+#endif
+}
+
+// arguments which are neither on the command line nor in the environment take
+// their values from the config file, the last line wins unless they append
+void argparse::Matcher::applyConfig()
+{
+    if (!this->config || this->config->empty())
+    {
+        return;
+    }
 
-            // set argument to found
-            argument->setPresent(true);
+    // lines of the same argument must not block each other
+    std::pmr::vector<bool> blocked(this->slots.size(), false, this->parsed.resource());
+    for (auto i = 0u; i < this->slots.size(); ++i)
+    {
+        blocked[i] = this->slots[i].present;
+    }
 
-            if (argument->type() == Argument::Boolean)
-            {
-                argument->setValue("true");
-                continue;
-            }
-            else if (argument->type() == Argument::String)
+    for (auto&& [position, value] : *this->config)
+    {
+        if (blocked[position])
+        {
+            continue;
+        }
+
+        if (this->definitions[position].type() == Argument::Boolean)
+        {
+            const bool enabled = is_enabled(value);
+            this->slots[position].present = enabled;
+            this->slots[position].value = enabled ? std::optional<std::string_view>("true") : std::nullopt;
+        }
+        else
+        {
+            this->slots[position].present = true;
+            this->setValue(position, value);
+        }
+    }
+}
+
+// sort the appended values by argument with a counting sort, so the values
+// of every argument are a contiguous range in command line order
+void argparse::Matcher::groupAppendedValues()
+{
+    if (this->appended.empty())
+    {
+        return;
+    }
+
+    for (auto&& [position, value] : this->appended)
+    {
+        ++this->slots[position].appendedCount;
+    }
+
+    std::uint32_t begin = 0;
+    for (auto&& slot : this->slots)
+    {
+        slot.appendedBegin = begin;
+        begin += slot.appendedCount;
+        slot.appendedCount = 0;
+    }
+
+    this->appendedValues.resize(this->appended.size());
+    for (auto&& [position, value] : this->appended)
+    {
+        auto &slot = this->slots[position];
+        this->appendedValues[slot.appendedBegin + slot.appendedCount++] = value;
+    }
+}
+
+void argparse::Matcher::feed(std::string_view arg)
+{
+    ++this->fed;
+
+    if (this->terminated)
+    {
+        this->remainingArguments.emplace_back(arg);
+        return;
+    }
+
+    const Token token = this->classify(arg);
+
+    // the previous string option takes this argument as value
+    if (this->pendingValue != ArgumentSchema::npos)
+    {
+        const auto position = this->pendingValue;
+        this->pendingValue = ArgumentSchema::npos;
+
+        if (token.type == OptionType::Value)
+        {
+            this->setValue(position, token.name);
+            return;
+        }
+    }
+
+    if (this->terminator.size() > 0 && arg == this->terminator)
+    {
+        this->terminated = true;
+        return;
+    }
+
+    if (token.type == OptionType::Value)
+    {
+        // the arguments after a subcommand belong to the subcommand
+        if (this->selectsSubcommands)
+        {
+            this->selectedSubcommand = this->schema.findSubcommand(token.name);
+            if (this->selectedSubcommand != ArgumentSchema::npos)
             {
-                const auto next = next_option();
-                if (!next.has_value())
-                {
-                    argument->setValue(""); // assume empty string, rather than an error
-                    continue;
-                }
-                else
-                {
-                    if (is_value(next.value()))
-                    {
-                        argument->setValue(next.value());
-                        i++;
-                        continue;
-                    }
-                    else
-                    {
-                        continue;
-                    }
-                }
+                return;
             }
         }
-        else if (type == OptionType::Value || type == OptionType::Unknown)
+
+        // positional arguments are assigned once the number of values is known, values
+        // beyond what they can take go to the lose argument handler right away
+        if (this->positionals.size() > 0 &&
+            !(this->loseArgumentHandler && this->positionalValues.size() >= this->positionalCapacity))
+        {
+            this->positionalValues.emplace_back(this->values ? std::string_view(this->values->emplace_back(token.name)) : token.name);
+            return;
+        }
+
+        // found a lose argument
+        this->addLoseArgument(token.name);
+        return;
+    }
+
+    // value which was given in the same token as its option, `--output=file`,
+    // the token is split in place and the value is a view into the argument
+    std::string_view name = token.name;
+    std::optional<std::string_view> attachedValue;
+
+    if (const auto separator = name.find('='); separator != std::string_view::npos)
+    {
+        attachedValue = name.substr(separator + 1);
+        name = name.substr(0, separator);
+    }
+
+    auto position = this->findArgument(name, token.type);
+
+    if (position == ArgumentSchema::npos && token.type == OptionType::Short && token.name.size() > 1)
+    {
+        attachedValue.reset();
+        position = this->findBundle(token.name, attachedValue);
+    }
+
+    // unique prefix of a long name
+    if (position == ArgumentSchema::npos && token.type == OptionType::Long)
+    {
+        bool ambiguous = false;
+        position = this->schema.findAbbreviation(name, ambiguous);
+        if (ambiguous)
+        {
+            this->ambiguousArguments.emplace_back(arg);
+            return;
+        }
+    }
+
+    if (position == ArgumentSchema::npos)
+    {
+        return;
+    }
+
+    // set argument to found
+    const auto &definition = this->definitions[position];
+    auto &slot = this->slots[position];
+    slot.present = true;
+
+    if (definition.type() == Argument::Boolean)
+    {
+        // `--verbose=false` turns the switch off, like the environment and config file
+        const bool enabled = !attachedValue.has_value() || is_enabled(attachedValue.value());
+        slot.present = enabled;
+        slot.value = enabled ? std::optional<std::string_view>("true") : std::nullopt;
+    }
+    else
+    {
+        if (attachedValue.has_value())
+        {
+            this->setValue(position, attachedValue.value());
+        }
+        else
         {
-            // found a lose argument
-            loseArguments.emplace_back(name);
+            this->pendingValue = position;
         }
     }
+}
+
+argparse::ArgumentParserResult argparse::Matcher::finish()
+{
+    using Res = ArgumentParserResult;
+
+    // the last argument is a string option
+    if (this->pendingValue != ArgumentSchema::npos)
+    {
+        this->setValue(this->pendingValue, ""); // assume empty string, rather than an error
+        this->pendingValue = ArgumentSchema::npos;
+    }
+
+    // command line > environment > config file > default value
+    this->applyEnvironment();
+    this->applyConfig();
+
+    // no args given
+    if (this->fed == 0)
+    {
+        this->assignPositionals();
+        this->groupAppendedValues();
+        return has_required_arguments(this->definitions, this->slots) || this->missingArguments.size() != 0 ?
+            Res::InsufficientArguments : Res::Success;
+    }
+
+    this->assignPositionals();
+    this->groupAppendedValues();
 
     // check if required arguments are missing
-    for (auto& argument : registeredArguments)
+    for (auto i = 0u; i < this->definitions.size(); ++i)
     {
-        if (argument.required() && !argument.present())
+        const auto &argument = this->definitions[i];
+        auto &slot = this->slots[i];
+        if (argument.required() && !slot.present)
         {
             // check if there is a default value to fall back
             if (argument.hasDefaultValue())
             {
                 // make argument present even though it was omitted on the command line
                 // but don't set a value on it, so the default value is taken instead
-                argument.setPresent(true);
+                slot.present = true;
             }
             else
             {
-                missingArguments.emplace_back(argument.name());
+                this->missingArguments.emplace_back(argument.name());
             }
         }
     }
 
-    if (missingArguments.size() != 0)
+    if (this->ambiguousArguments.size() != 0)
+    {
+        return Res::AmbiguousArgument;
+    }
+    else if (this->missingArguments.size() != 0)
     {
         return Res::MissingArgument;
     }
 
     return Res::Success;
 }
+
+argparse::ArgumentParserResult argparse::Matcher::parseSubcommand(const CommandLine &args)
+{
+    const auto &subcommand = this->schema.subcommands()[this->selectedSubcommand];
+    const auto resource = this->parsed.resource();
+
+    this->parsed._subcommandName = subcommand.name();
+    this->parsed._subcommand = std::allocate_shared<ParsedArguments>(
+        std::pmr::polymorphic_allocator<ParsedArguments>(resource), subcommand.schema(this->schema).parse(args, resource));
+
+    return this->parsed._subcommand->result();
+}
+
+argparse::ArgumentParserResult argparse::parse(
+    const argparse::ArgumentSchema &schema, const CommandLine &args, ParsedArguments &parsed,
+    const ConfigValues *config)
+{
+    Matcher matcher(schema, parsed);
+    matcher.selectSubcommands(true);
+    matcher.setConfigValues(config);
+
+    // the first argument is the application
+    auto i = 1u;
+    while (i < args.size() && matcher.subcommand() == ArgumentSchema::npos)
+    {
+        matcher.feed(args[i++]);
+    }
+
+    const auto result = matcher.finish();
+
+    // the subcommand name takes the place of the application
+    if (matcher.subcommand() != ArgumentSchema::npos)
+    {
+        const auto subcommandResult = matcher.parseSubcommand(args.subview(i - 1));
+        return result == ArgumentParserResult::Success ? subcommandResult : result;
+    }
+
+    return result;
+}
@@ -1,16 +1,166 @@
 #pragma once
 
-#include <argparse/argparse.hpp>
+#include <argparse/schema.hpp>
+
+#include "config_file.hpp"
+
+#include <string_view>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <cstddef>
 
 namespace argparse {
 
-using StringList = std::list<std::string>;
+// stable storage for copied values, the parsed values refer to its strings
+using ValueStorage = ParsedArguments::Values;
+
+/**
+ * Matches arguments against a schema one at a time, the arguments
+ * don't need to be known in advance. The first argument of a command
+ * line (the application) must not be fed.
+ *
+ * Parsed values are views into the fed arguments unless they
+ * are copied with `copyValuesInto()`.
+ */
+struct Matcher final
+{
+public:
+    using LoseArgumentHandler = ArgumentSchema::LoseArgumentHandler;
+
+    /**
+     * Matches into the slots and lists of the given result,
+     * the slots must be sized for the schema already.
+     */
+    Matcher(const ArgumentSchema &schema, ParsedArguments &parsed);
+
+    /**
+     * Copies the values of options into the given list, for arguments
+     * which don't outlive the `feed()` call.
+     */
+    inline void copyValuesInto(ValueStorage *values)
+    {
+        this->values = values;
+        this->ownedValues.assign(this->definitions.size(), nullptr);
+    }
+
+    /**
+     * Passes lose arguments to the given handler instead of storing them.
+     */
+    inline void setLoseArgumentHandler(const LoseArgumentHandler *handler)
+    {
+        this->loseArgumentHandler = handler;
+    }
+
+    /**
+     * Takes the values of arguments which are neither on the command line
+     * nor in the environment from the given config file values.
+     */
+    inline void setConfigValues(const ConfigValues *config)
+    {
+        this->config = config;
+    }
+
+    /**
+     * Stops at the first value which is the name of a subcommand,
+     * see `subcommand()`. Nothing must be fed after that.
+     */
+    inline void selectSubcommands(bool enable)
+    {
+        this->selectsSubcommands = enable && this->schema.subcommands().size() > 0;
+    }
+
+    /**
+     * Position of the selected subcommand or `npos`.
+     */
+    inline std::size_t subcommand() const
+    {
+        return this->selectedSubcommand;
+    }
+
+    /**
+     * Parses the arguments of the selected subcommand into the result,
+     * the first argument is the subcommand name.
+     */
+    ArgumentParserResult parseSubcommand(const CommandLine &args);
+
+    void feed(std::string_view arg);
+
+    /**
+     * Assigns the positional arguments, checks for missing arguments
+     * and groups the appended values once all arguments were fed.
+     */
+    ArgumentParserResult finish();
+
+private:
+    enum class OptionType
+    {
+        Short,
+        Long,
+        Value,
+    };
+
+    // a classified command line token, the name excludes the option prefix
+    struct Token final
+    {
+        OptionType type;
+        std::string_view name;
+    };
+
+    Token classify(std::string_view token) const;
+    std::size_t findArgument(std::string_view name, OptionType type) const;
+    std::size_t findBundle(std::string_view name, std::optional<std::string_view> &attachedValue);
+    void setValue(std::size_t position, std::string_view value);
+    void addLoseArgument(std::string_view value);
+    void assignPositionals();
+    void applyEnvironment();
+    void applyConfig();
+    void groupAppendedValues();
+
+    const ArgumentSchema &schema;
+    const ArgumentSchema::Definitions definitions;
+    const ArgumentSchema::Positionals &positionals;
+
+    const std::string &shortOptionPrefix;
+    const std::string &longOptionPrefix;
+    const std::string &terminator;
+
+    ParsedArguments &parsed;
+    ParsedArguments::Slots &slots;
+    ParsedArguments::AppendedValues &appendedValues;
+    ParsedArguments::PositionalValues &positionalValues;
+    std::pmr::vector<TypedValue> &positionalCache;
+    ParsedArguments::PositionalRanges &positionalRanges;
+    StringList &missingArguments;
+    StringList &ambiguousArguments;
+    StringList &loseArguments;
+    StringList &remainingArguments;
+
+    ValueStorage *values = nullptr;
+
+    // number of values the positional arguments take at most, saturated for variadic ones
+    std::size_t positionalCapacity = 0;
+
+    // copy of the value of every single value option, overwritten when it repeats
+    std::pmr::vector<std::pmr::string*> ownedValues;
+    const LoseArgumentHandler *loseArgumentHandler = nullptr;
+    const ConfigValues *config = nullptr;
+
+    std::size_t fed = 0;
+    bool terminated = false;
+
+    // string option which takes the next argument as value if it isn't an option
+    std::size_t pendingValue = ArgumentSchema::npos;
+
+    bool selectsSubcommands = false;
+    std::size_t selectedSubcommand = ArgumentSchema::npos;
+
+    // values of `Append` arguments in command line order
+    std::pmr::vector<std::pair<std::uint32_t, std::string_view>> appended;
+};
 
 ArgumentParserResult parse(
-    const ArgumentParser &parserInstance,
-    const std::vector<std::string> &args, argparse::ArgumentParser::Arguments &registeredArguments,
-    const std::string &shortOptionPrefix, const std::string &longOptionPrefix,
-    const std::string &terminator,
-    StringList &missingArguments, StringList &loseArguments, StringList &remainingArguments);
+    const ArgumentSchema &schema, const CommandLine &args, ParsedArguments &parsed,
+    const ConfigValues *config = nullptr);
 
 } // namespace argparse
@@ -0,0 +1,9 @@
+#pragma once
+
+// POSIX systems map files with `mmap()` and scan `environ` for environment
+// variables, other systems fall back to the standard library
+#if defined(__unix__) || defined(__APPLE__)
+#define LIBARGPARSE_POSIX 1
+#else
+#define LIBARGPARSE_POSIX 0
+#endif
@@ -2,14 +2,14 @@
 
 #include "wcwidth.hpp"
 
-#include <list>
+#include <vector>
 #include <string>
 #include <locale>
 #include <codecvt>
 
 using namespace argparse;
 
-using Arguments = ArgumentParser::Arguments;
+using Definitions = ArgumentSchema::Definitions;
 
 namespace {
 
@@ -33,20 +33,12 @@ static std::uint64_t wcwidth_string(const std::string &str)
     return length;
 }
 
-static std::string make_spaces(std::uint8_t length)
-{
-    std::string spaces;
-    for (std::uint8_t i = 0; i < length; ++i)
-    {
-        spaces += ' ';
-    }
-    return spaces;
-}
-
 } // anonymous namespace
 
 const std::string argparse::format(
-    const argparse::ArgumentParser &parserInstance, const Arguments &arguments,
+    const argparse::ArgumentSchema &schemaInstance, Definitions definitions,
+    const ArgumentSchema::Positionals &positionals,
+    const ArgumentSchema::Subcommands &subcommands,
     bool visualizeStringOptions, const std::string &stringOptionSuffix,
     std::uint8_t indentation, std::uint8_t spacing,
     const std::string &shortOptionPrefix, const std::string &longOptionPrefix)
@@ -56,18 +48,21 @@ const std::string argparse::format(
 
     struct FormattedArgument
     {
-        const std::string left;
-        const std::string right;
+        std::string left;
+        std::uint64_t width;
+        std::string_view right;
     };
 
-    std::list<FormattedArgument> formatted_arguments;
-    for (auto&& arg : arguments)
+    std::vector<FormattedArgument> formatted_arguments;
+    formatted_arguments.reserve(definitions.size() + positionals.size() + subcommands.size());
+    for (auto&& arg : definitions)
     {
         const auto build_left_part = [&](std::uint64_t &length) {
             std::string part;
             if (arg.hasShortName())
             {
-                part += shortOptionPrefix + arg.shortName();
+                part += shortOptionPrefix;
+                part += arg.shortName();
                 if (arg.hasLongName())
                 {
                     part += ", ";
@@ -75,9 +70,10 @@ const std::string argparse::format(
             }
             if (arg.hasLongName())
             {
-                part += longOptionPrefix + arg.longName();
+                part += longOptionPrefix;
+                part += arg.longName();
             }
-            if (visualizeStringOptions && arg.type() == Argument::String)
+            if (visualizeStringOptions && arg.type() != Argument::Boolean)
             {
                 part += stringOptionSuffix;
             }
@@ -86,7 +82,35 @@ const std::string argparse::format(
         };
 
         std::uint64_t length = 0;
-        formatted_arguments.emplace_back(FormattedArgument{build_left_part(length), arg.description()});
+        auto left = build_left_part(length);
+        formatted_arguments.emplace_back(FormattedArgument{std::move(left), length, arg.description()});
+
+        if (length > longest_option)
+        {
+            longest_option = length;
+        }
+    }
+
+    // positional arguments are listed after the options, `name`, `[name]`, `name...` or `[name...]`
+    for (auto&& positional : positionals)
+    {
+        std::string left;
+        if (positional.minimum() == 0)
+        {
+            left += '[';
+        }
+        left += positional.name();
+        if (positional.maximum() > 1)
+        {
+            left += "...";
+        }
+        if (positional.minimum() == 0)
+        {
+            left += ']';
+        }
+
+        const auto length = wcwidth_string(left);
+        formatted_arguments.emplace_back(FormattedArgument{std::move(left), length, positional.description()});
 
         if (length > longest_option)
         {
@@ -94,14 +118,27 @@ const std::string argparse::format(
         }
     }
 
-    for (auto&&  arg : formatted_arguments)
+    // subcommands are listed last, their schemas aren't created for this
+    for (auto&& subcommand : subcommands)
     {
-        std::string fill;
-        for (std::uint64_t i = 0; i < longest_option - wcwidth_string(arg.left); ++i)
+        const auto length = wcwidth_string(subcommand.name());
+        formatted_arguments.emplace_back(FormattedArgument{subcommand.name(), length, subcommand.description()});
+
+        if (length > longest_option)
         {
-            fill += ' ';
+            longest_option = length;
         }
-        help_text += make_spaces(indentation) + arg.left + ' ' + fill + make_spaces(spacing) + arg.right + '\n';
+    }
+
+    for (auto&& arg : formatted_arguments)
+    {
+        help_text.append(indentation, ' ');
+        help_text += arg.left;
+        help_text += ' ';
+        help_text.append(longest_option - arg.width, ' ');
+        help_text.append(spacing, ' ');
+        help_text += arg.right;
+        help_text += '\n';
     }
 
     return help_text;
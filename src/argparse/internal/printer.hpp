@@ -1,11 +1,13 @@
 #pragma once
 
-#include <argparse/argparse.hpp>
+#include <argparse/schema.hpp>
 
 namespace argparse {
 
 const std::string format(
-    const ArgumentParser &parserInstance, const ArgumentParser::Arguments &arguments,
+    const ArgumentSchema &schemaInstance, ArgumentSchema::Definitions definitions,
+    const ArgumentSchema::Positionals &positionals,
+    const ArgumentSchema::Subcommands &subcommands,
     bool visualizeStringOptions, const std::string &stringOptionSuffix,
     std::uint8_t indentation, std::uint8_t spacing,
     const std::string &shortOptionPrefix, const std::string &longOptionPrefix);
@@ -0,0 +1,380 @@
+#include "response_file.hpp"
+#include "platform.hpp"
+
+#include <string>
+#include <memory>
+#include <cerrno>
+
+#if LIBARGPARSE_POSIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+using namespace argparse;
+
+using Res = ArgumentParserResult;
+
+argparse::MappedFile::MappedFile(char *data, std::size_t size, std::size_t capacity)
+    : _data(data),
+      _size(size),
+      _capacity(capacity > size ? capacity : size)
+{
+}
+
+argparse::MappedFile::~MappedFile()
+{
+#if LIBARGPARSE_POSIX
+    ::munmap(this->_data, this->_capacity);
+#else
+    delete[] this->_data;
+#endif
+}
+
+namespace {
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static bool is_response_file(std::string_view arg)
+{
+    return arg.size() > 1 && arg[0] == '@';
+}
+
+// state of a single expansion, shared by all nesting levels
+struct Expander final
+{
+    const std::string &terminator;
+    const std::uint8_t maxDepth;
+
+    std::pmr::vector<std::string_view> &tokens;
+    ParsedArguments::ResponseFiles &files;
+
+    // once the terminator was seen all following arguments are taken as they are
+    bool terminated = false;
+
+    Res add(std::string_view token, bool expandable, unsigned depth)
+    {
+        if (!this->terminated && this->terminator.size() > 0 && token == this->terminator)
+        {
+            this->terminated = true;
+        }
+        else if (!this->terminated && expandable && is_response_file(token))
+        {
+            return this->expand(std::string(token.substr(1)), depth + 1);
+        }
+
+        this->tokens.emplace_back(token);
+        return Res::Success;
+    }
+
+    Res expand(const std::string &path, unsigned depth)
+    {
+        if (depth > this->maxDepth)
+        {
+            return Res::ResponseFileNesting;
+        }
+
+        const MappedFile *file = nullptr;
+        if (!argparse::map_file(path, this->files, file))
+        {
+            return Res::ResponseFileError;
+        }
+
+        return file ? this->tokenize(file->data(), file->size(), depth) : Res::Success;
+    }
+
+    // split the file into tokens and remove the quoting in place,
+    // the write position never overtakes the read position
+    Res tokenize(char *data, std::size_t size, unsigned depth)
+    {
+        char *read = data;
+        char *const end = data + size;
+
+        // comments are only recognized at the start of a line
+        bool lineStart = true;
+
+        while (read < end)
+        {
+            if (is_space(*read))
+            {
+                lineStart = lineStart || *read == '\n';
+                ++read;
+                continue;
+            }
+
+            if (lineStart && *read == '#')
+            {
+                while (read < end && *read != '\n')
+                {
+                    ++read;
+                }
+                continue;
+            }
+
+            char *const start = read;
+            char *write = read;
+
+            const auto take = [&]{
+                if (write != read)
+                {
+                    *write = *read;
+                }
+                ++write;
+                ++read;
+            };
+
+            // only unquoted `@file` tokens are expanded
+            const bool expandable = *start == '@';
+
+            while (read < end && !is_space(*read))
+            {
+                if (*read == '\'')
+                {
+                    ++read;
+                    while (read < end && *read != '\'')
+                    {
+                        take();
+                    }
+                    if (read == end)
+                    {
+                        return Res::ResponseFileError; // unterminated quote
+                    }
+                    ++read;
+                }
+                else if (*read == '"')
+                {
+                    ++read;
+                    while (read < end && *read != '"')
+                    {
+                        if (*read == '\\' && (read + 1) < end && (read[1] == '"' || read[1] == '\\'))
+                        {
+                            ++read;
+                        }
+                        take();
+                    }
+                    if (read == end)
+                    {
+                        return Res::ResponseFileError; // unterminated quote
+                    }
+                    ++read;
+                }
+                else if (*read == '\\')
+                {
+                    ++read;
+                    if (read < end)
+                    {
+                        take();
+                    }
+                }
+                else
+                {
+                    take();
+                }
+            }
+
+            lineStart = false;
+
+            const auto result = this->add(std::string_view(start, static_cast<std::size_t>(write - start)), expandable, depth);
+            if (result != Res::Success)
+            {
+                return result;
+            }
+        }
+
+        return Res::Success;
+    }
+};
+
+#if !LIBARGPARSE_POSIX
+// without `mmap()` the file is read into a buffer on the heap, which is
+// a copy too, the file may shrink while it is read
+static bool read_file(const std::string &path, ParsedArguments::ResponseFiles &files, const MappedFile *&file)
+{
+    file = nullptr;
+
+    std::ifstream stream(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!stream)
+    {
+        return false;
+    }
+
+    const auto end = stream.tellg();
+    if (end < 0)
+    {
+        return false;
+    }
+
+    const auto capacity = static_cast<std::size_t>(end);
+    if (capacity == 0)
+    {
+        return true;
+    }
+
+    std::unique_ptr<char[]> data(new char[capacity]);
+    stream.seekg(0);
+    stream.read(data.get(), static_cast<std::streamsize>(capacity));
+    if (stream.bad())
+    {
+        return false;
+    }
+    const auto size = static_cast<std::size_t>(stream.gcount());
+
+    file = files.emplace_back(std::allocate_shared<MappedFile>(
+        std::pmr::polymorphic_allocator<MappedFile>(files.get_allocator().resource()), data.get(), size, capacity)).get();
+    data.release();
+    return true;
+}
+#endif
+
+} // anonymous namespace
+
+bool argparse::map_file(const std::string &path, ParsedArguments::ResponseFiles &files, const MappedFile *&file)
+{
+#if !LIBARGPARSE_POSIX
+    return read_file(path, files, file);
+#else
+    file = nullptr;
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    const auto size = static_cast<std::size_t>(info.st_size);
+    if (size == 0)
+    {
+        ::close(fd);
+        return true;
+    }
+
+    // private mapping, unquoting writes into copies of the touched pages only
+    void *data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+    ::madvise(data, size, MADV_SEQUENTIAL);
+
+    file = files.emplace_back(std::allocate_shared<MappedFile>(
+        std::pmr::polymorphic_allocator<MappedFile>(files.get_allocator().resource()), static_cast<char*>(data), size)).get();
+    return true;
+#endif
+}
+
+bool argparse::copy_file(const std::string &path, ParsedArguments::ResponseFiles &files, const MappedFile *&file)
+{
+#if !LIBARGPARSE_POSIX
+    return read_file(path, files, file);
+#else
+    file = nullptr;
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    const auto capacity = static_cast<std::size_t>(info.st_size);
+    if (capacity == 0)
+    {
+        ::close(fd);
+        return true;
+    }
+
+    void *data = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    // the file may shrink while it is read, the copy ends there
+    std::size_t size = 0;
+    while (size < capacity)
+    {
+        const auto count = ::read(fd, static_cast<char*>(data) + size, capacity - size);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else if (count < 0)
+        {
+            ::close(fd);
+            ::munmap(data, capacity);
+            return false;
+        }
+        else if (count == 0)
+        {
+            break;
+        }
+        size += static_cast<std::size_t>(count);
+    }
+    ::close(fd);
+
+    file = files.emplace_back(std::allocate_shared<MappedFile>(
+        std::pmr::polymorphic_allocator<MappedFile>(files.get_allocator().resource()), static_cast<char*>(data), size, capacity)).get();
+    return true;
+#endif
+}
+
+bool argparse::has_response_files(const CommandLine &args, const std::string &terminator)
+{
+    for (auto i = 1u; i < args.size(); ++i)
+    {
+        if (terminator.size() > 0 && args[i] == terminator)
+        {
+            return false;
+        }
+        if (is_response_file(args[i]))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+argparse::ArgumentParserResult argparse::expand_response_files(
+    const CommandLine &args, const std::string &terminator, std::uint8_t maxDepth,
+    std::pmr::vector<std::string_view> &tokens, ParsedArguments::ResponseFiles &files)
+{
+    Expander expander{terminator, maxDepth, tokens, files};
+
+    if (args.size() > 0)
+    {
+        tokens.emplace_back(args[0]);
+    }
+
+    for (auto i = 1u; i < args.size(); ++i)
+    {
+        const auto result = expander.add(args[i], true, 0);
+        if (result != Res::Success)
+        {
+            return result;
+        }
+    }
+
+    return Res::Success;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <argparse/schema.hpp>
+
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace argparse {
+
+/**
+ * Private writable memory mapping of a response or config file,
+ * unmapped once the last parse result referencing it is gone.
+ * The mapping may be larger than the content. Systems without
+ * `mmap()` use a buffer on the heap instead.
+ */
+struct MappedFile final
+{
+public:
+    MappedFile(char *data, std::size_t size, std::size_t capacity = 0);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    inline char *data() const
+    {
+        return this->_data;
+    }
+
+    inline std::size_t size() const
+    {
+        return this->_size;
+    }
+
+private:
+    char *_data = nullptr;
+    std::size_t _size = 0;
+    std::size_t _capacity = 0;
+};
+
+/**
+ * Maps the given file privately and appends the mapping to `files`, `file` points
+ * to it afterwards. Empty files aren't mapped, `file` is `nullptr` for them.
+ *
+ * Systems without `mmap()` read the file with `std::ifstream`.
+ *
+ * Returns false if the file can't be opened or mapped.
+ */
+bool map_file(const std::string &path, ParsedArguments::ResponseFiles &files, const MappedFile *&file);
+
+/**
+ * Like `map_file()`, but reads the file into an anonymous mapping. Unlike a private
+ * file mapping the copy doesn't see later writes to the file, which matters for
+ * files which are rewritten while results still refer to them.
+ */
+bool copy_file(const std::string &path, ParsedArguments::ResponseFiles &files, const MappedFile *&file);
+
+/**
+ * Checks if any argument after the application is a `@file` response file.
+ */
+bool has_response_files(const CommandLine &args, const std::string &terminator);
+
+/**
+ * Replaces every `@file` argument with the tokens of the file. Files are split at
+ * whitespace, single quotes preserve everything literally, double quotes and the
+ * backslash escape the next character. Lines starting with `#` are comments.
+ *
+ * The files are mapped privately and unquoted in place, the tokens are views into
+ * the mappings which are appended to `files`. Arguments after the terminator are
+ * taken as they are.
+ */
+ArgumentParserResult expand_response_files(
+    const CommandLine &args, const std::string &terminator, std::uint8_t maxDepth,
+    std::pmr::vector<std::string_view> &tokens, ParsedArguments::ResponseFiles &files);
+
+} // namespace argparse
@@ -0,0 +1,55 @@
+#include "stream.hpp"
+
+#include <vector>
+#include <cstring>
+
+bool argparse::read_records(
+    const ReadFunction &read, std::size_t bufferSize, const std::function<void(std::string_view)> &record,
+    std::pmr::memory_resource *resource)
+{
+    if (bufferSize == 0)
+    {
+        return false;
+    }
+
+    std::pmr::vector<char> buffer(bufferSize, resource);
+
+    // unprocessed bytes are kept at the beginning of the buffer
+    std::size_t used = 0;
+
+    while (true)
+    {
+        const auto count = read(buffer.data() + used, bufferSize - used);
+        if (count < 0)
+        {
+            return false;
+        }
+        else if (count == 0)
+        {
+            // the last record isn't terminated
+            if (used > 0)
+            {
+                record(std::string_view(buffer.data(), used));
+            }
+            return true;
+        }
+
+        // only the new bytes can contain a terminator
+        const char *begin = buffer.data();
+        const char *const end = buffer.data() + used + static_cast<std::size_t>(count);
+        const char *scan = buffer.data() + used;
+
+        while (const auto terminator = static_cast<const char*>(std::memchr(scan, '\0', static_cast<std::size_t>(end - scan))))
+        {
+            record(std::string_view(begin, static_cast<std::size_t>(terminator - begin)));
+            begin = scan = terminator + 1;
+        }
+
+        used = static_cast<std::size_t>(end - begin);
+        if (used == bufferSize)
+        {
+            return false; // the record doesn't fit into the buffer
+        }
+        std::memmove(buffer.data(), begin, used);
+    }
+}
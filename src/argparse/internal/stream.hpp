@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string_view>
+#include <functional>
+#include <memory_resource>
+#include <cstddef>
+
+namespace argparse {
+
+// reads up to `size` bytes into the buffer, returns the number of read bytes,
+// zero at the end of the input and a negative number on errors
+using ReadFunction = std::function<long(char *buffer, std::size_t size)>;
+
+/**
+ * Reads NUL terminated records through a buffer of the given size and passes
+ * each one to `record`, the views are only valid during the call. The last
+ * record doesn't need to be terminated.
+ *
+ * Returns false on read errors and on records which don't fit into the buffer.
+ * The buffer is allocated from the given memory resource.
+ */
+bool read_records(
+    const ReadFunction &read, std::size_t bufferSize, const std::function<void(std::string_view)> &record,
+    std::pmr::memory_resource *resource);
+
+} // namespace argparse
@@ -0,0 +1,137 @@
+#include "work_stealing.hpp"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include <system_error>
+
+namespace {
+
+// remaining work of a single thread, the owner takes from the front and thieves from the back
+struct alignas(64) WorkRange final
+{
+    std::mutex mutex;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+};
+
+using WorkRanges = std::vector<WorkRange>;
+
+// take the next chunk of the own range
+static bool take_chunk(WorkRange &range, std::size_t chunkSize, std::size_t &begin, std::size_t &end)
+{
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if (range.begin >= range.end)
+    {
+        return false;
+    }
+
+    begin = range.begin;
+    end = std::min(range.begin + chunkSize, range.end);
+    range.begin = end;
+    return true;
+}
+
+// move half of the remaining work of another thread into the own range
+static bool steal(WorkRanges &ranges, std::size_t self)
+{
+    for (auto offset = 1u; offset < ranges.size(); ++offset)
+    {
+        auto &victim = ranges[(self + offset) % ranges.size()];
+
+        std::size_t begin = 0, end = 0;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.begin >= victim.end)
+            {
+                continue;
+            }
+
+            const auto remaining = victim.end - victim.begin;
+            begin = victim.end - (remaining + 1) / 2;
+            end = victim.end;
+            victim.end = begin;
+        }
+
+        std::lock_guard<std::mutex> lock(ranges[self].mutex);
+        ranges[self].begin = begin;
+        ranges[self].end = end;
+        return true;
+    }
+
+    return false;
+}
+
+static void run_worker(WorkRanges &ranges, std::size_t self, std::size_t chunkSize, const std::function<void(std::size_t)> &func)
+{
+    std::size_t begin = 0, end = 0;
+    for (;;)
+    {
+        if (take_chunk(ranges[self], chunkSize, begin, end))
+        {
+            for (auto i = begin; i < end; ++i)
+            {
+                func(i);
+            }
+        }
+        else if (!steal(ranges, self))
+        {
+            // nothing left anywhere, work which is in progress is never handed back
+            return;
+        }
+    }
+}
+
+} // anonymous namespace
+
+void argparse::parallel_for(std::size_t count, unsigned threads, const std::function<void(std::size_t)> &func)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    threads = std::max(1u, threads);
+    if (threads == 1 || count == 1)
+    {
+        for (auto i = 0u; i < count; ++i)
+        {
+            func(i);
+        }
+        return;
+    }
+
+    // equal shares to start with
+    WorkRanges ranges(threads);
+    for (auto t = 0u; t < threads; ++t)
+    {
+        ranges[t].begin = count * t / threads;
+        ranges[t].end = count * (t + 1) / threads;
+    }
+
+    // small chunks keep the owner's range stealable, large enough to amortize locking
+    const auto chunkSize = std::clamp<std::size_t>(count / (threads * 16), 1, 256);
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (auto t = 1u; t < threads; ++t)
+    {
+        try
+        {
+            workers.emplace_back(run_worker, std::ref(ranges), t, chunkSize, std::cref(func));
+        }
+        catch (const std::system_error &)
+        {
+            // the ranges of threads which couldn't be started are stolen by the running ones
+            break;
+        }
+    }
+
+    run_worker(ranges, 0, chunkSize, func);
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
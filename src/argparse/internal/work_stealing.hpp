@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace argparse {
+
+/**
+ * Calls `func(i)` for every `i` in `[0, count)` using the given number of threads,
+ * the calling thread is one of them. Every thread starts with an equal share of the
+ * index range and steals half of the remaining work of another thread once its
+ * own share is exhausted.
+ */
+void parallel_for(std::size_t count, unsigned threads, const std::function<void(std::size_t)> &func);
+
+} // namespace argparse
@@ -0,0 +1,154 @@
+#include "prefix_tree.hpp"
+
+namespace {
+
+// returned by findChild() when there is no such child, the root is never a child
+static constexpr std::uint32_t no_child = 0;
+
+static std::size_t common_prefix(std::string_view a, std::string_view b)
+{
+    std::size_t i = 0;
+    while (i < a.size() && i < b.size() && a[i] == b[i])
+    {
+        ++i;
+    }
+    return i;
+}
+
+} // anonymous namespace
+
+argparse::PrefixTree::PrefixTree()
+{
+    this->clear();
+}
+
+void argparse::PrefixTree::clear()
+{
+    this->nodes.clear();
+    this->nodes.emplace_back();
+}
+
+std::uint32_t argparse::PrefixTree::findChild(std::uint32_t node, char c) const
+{
+    // the children start with distinct characters, so there are only few of them
+    for (const auto child : this->nodes[node].children)
+    {
+        if (this->nodes[child].label[0] == c)
+        {
+            return child;
+        }
+    }
+    return no_child;
+}
+
+void argparse::PrefixTree::insert(std::string_view name, std::size_t position)
+{
+    std::uint32_t node = 0;
+    std::string_view rest = name;
+
+    while (true)
+    {
+        auto &current = this->nodes[node];
+        ++current.names;
+        if (current.anyPosition == npos)
+        {
+            current.anyPosition = position;
+        }
+
+        if (rest.empty())
+        {
+            current.position = position;
+            return;
+        }
+
+        auto child = this->findChild(node, rest[0]);
+        if (child == no_child)
+        {
+            Node leaf;
+            leaf.label = rest;
+            leaf.position = position;
+            leaf.anyPosition = position;
+            leaf.names = 1;
+
+            const auto added = static_cast<std::uint32_t>(this->nodes.size());
+            this->nodes.emplace_back(std::move(leaf));
+            this->nodes[node].children.emplace_back(added);
+            return;
+        }
+
+        const auto label = this->nodes[child].label;
+        const auto common = common_prefix(label, rest);
+
+        // the name leaves the edge in the middle, split it
+        if (common < label.size())
+        {
+            Node middle;
+            middle.label = label.substr(0, common);
+            middle.anyPosition = this->nodes[child].anyPosition;
+            middle.names = this->nodes[child].names;
+            middle.children.emplace_back(child);
+
+            const auto added = static_cast<std::uint32_t>(this->nodes.size());
+            this->nodes.emplace_back(std::move(middle));
+            this->nodes[child].label = label.substr(common);
+
+            for (auto &c : this->nodes[node].children)
+            {
+                if (c == child)
+                {
+                    c = added;
+                }
+            }
+            child = added;
+        }
+
+        node = child;
+        rest = rest.substr(common);
+    }
+}
+
+std::size_t argparse::PrefixTree::find(std::string_view prefix, bool &ambiguous) const
+{
+    ambiguous = false;
+    if (prefix.empty())
+    {
+        return npos;
+    }
+
+    std::uint32_t node = 0;
+    std::string_view rest = prefix;
+    bool endsAtNode = true;
+
+    while (!rest.empty())
+    {
+        const auto child = this->findChild(node, rest[0]);
+        if (child == no_child)
+        {
+            return npos;
+        }
+
+        const auto label = this->nodes[child].label;
+        const auto length = label.size() < rest.size() ? label.size() : rest.size();
+        if (label.substr(0, length) != rest.substr(0, length))
+        {
+            return npos;
+        }
+
+        endsAtNode = length == label.size();
+        node = child;
+        rest = rest.substr(length);
+    }
+
+    const auto &found = this->nodes[node];
+    if (endsAtNode && found.position != npos)
+    {
+        return found.position;
+    }
+    else if (found.names == 1)
+    {
+        return found.anyPosition;
+    }
+
+    ambiguous = true;
+    return npos;
+}
@@ -0,0 +1,61 @@
+#ifndef LIBARGPARSE_PREFIX_TREE_HPP
+#define LIBARGPARSE_PREFIX_TREE_HPP
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace argparse {
+
+/**
+ * Radix tree over option names for resolving unique prefixes.
+ *
+ * Every edge holds a view into the inserted names, which must
+ * outlive the tree. Nodes with a single child are merged, so a
+ * lookup visits at most one node per character of the prefix.
+ */
+struct PrefixTree final
+{
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    PrefixTree();
+
+    /**
+     * Adds a name with the position of its argument.
+     */
+    void insert(std::string_view name, std::size_t position);
+
+    /**
+     * Returns the position of the name which equals the given prefix or the
+     * only name which starts with it. Returns `npos` if no name starts with
+     * the prefix or if there are multiple ones, `ambiguous` is set in the latter case.
+     */
+    std::size_t find(std::string_view prefix, bool &ambiguous) const;
+
+    void clear();
+
+    inline bool empty() const
+    {
+        return this->nodes.size() == 1;
+    }
+
+private:
+    struct Node final
+    {
+        std::string_view label;             // edge from the parent
+        std::size_t position = npos;        // the name ending at this node
+        std::size_t anyPosition = npos;     // any name in the subtree
+        std::size_t names = 0;              // number of names in the subtree
+        std::vector<std::uint32_t> children;
+    };
+
+    std::uint32_t findChild(std::uint32_t node, char c) const;
+
+    std::vector<Node> nodes;
+};
+
+} // namespace argparse
+
+#endif // LIBARGPARSE_PREFIX_TREE_HPP
@@ -0,0 +1,482 @@
+#include "schema.hpp"
+
+#include "internal/config_file.hpp"
+#include "internal/parser.hpp"
+#include "internal/platform.hpp"
+#include "internal/printer.hpp"
+#include "internal/response_file.hpp"
+#include "internal/stream.hpp"
+
+#include <istream>
+#include <algorithm>
+#include <cerrno>
+
+#if LIBARGPARSE_POSIX
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+argparse::ArgumentSchema::ArgumentSchema(const std::string &shortOptionPrefix, const std::string &longOptionPrefix)
+    : _shortOptionPrefix(shortOptionPrefix),
+      _longOptionPrefix(longOptionPrefix)
+{
+}
+
+argparse::ParsedArguments argparse::ArgumentSchema::parse(const CommandLine &commandLine, std::pmr::memory_resource *resource) const
+{
+    return this->parseCommandLine(commandLine, nullptr, nullptr, resource);
+}
+
+argparse::ParsedArguments argparse::ArgumentSchema::parse(
+    const CommandLine &commandLine, const std::string &configFile, std::pmr::memory_resource *resource) const
+{
+    return this->parseCommandLine(commandLine, &configFile, nullptr, resource);
+}
+
+argparse::ParsedArguments argparse::ArgumentSchema::parseCommandLine(
+    const CommandLine &commandLine, const std::string *configFile,
+    const std::shared_ptr<const MappedFile> *configContent, std::pmr::memory_resource *resource) const
+{
+    ParsedArguments parsed(resource);
+    parsed._schema = this;
+    parsed._slots.resize(this->definitions().size());
+
+    // the config values are views into the mapped file, which the result keeps alive
+    ConfigValues config(resource);
+    if (configContent)
+    {
+        if (*configContent)
+        {
+            const auto &file = parsed._responseFiles.emplace_back(*configContent);
+            parsed._result = argparse::tokenize_config(*this, file->data(), file->size(), config);
+        }
+        else
+        {
+            parsed._result = Result::Success;
+        }
+
+        if (parsed._result != Result::Success)
+        {
+            return parsed;
+        }
+    }
+    else if (configFile)
+    {
+        parsed._result = argparse::read_config_file(*this, *configFile, config, parsed._responseFiles);
+        if (parsed._result != Result::Success)
+        {
+            return parsed;
+        }
+    }
+
+    const auto parseInto = [&](const CommandLine &args) {
+        return argparse::parse(*this, args, parsed, configFile || configContent ? &config : nullptr);
+    };
+
+    // the expanded tokens are views into the command line and the response files
+    if (this->_responseFileDepth > 0 && argparse::has_response_files(commandLine, this->_terminator))
+    {
+        std::pmr::vector<std::string_view> tokens(resource);
+        parsed._result = argparse::expand_response_files(
+            commandLine, this->_terminator, this->_responseFileDepth, tokens, parsed._responseFiles);
+
+        if (parsed._result == Result::Success)
+        {
+            parsed._result = parseInto(CommandLine(tokens));
+        }
+        return parsed;
+    }
+
+    parsed._result = parseInto(commandLine);
+    return parsed;
+}
+
+argparse::ParsedArguments argparse::ArgumentSchema::parseStream(
+    int fd, const LoseArgumentHandler &loseArgument, std::size_t bufferSize,
+    std::pmr::memory_resource *resource) const
+{
+    return this->parseRecords([fd](char *buffer, std::size_t size) -> long {
+        while (true)
+        {
+#if LIBARGPARSE_POSIX
+            const auto count = ::read(fd, buffer, size);
+#else
+            const auto count = ::_read(fd, buffer, static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30)));
+#endif
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            return static_cast<long>(count);
+        }
+    }, loseArgument, bufferSize, resource);
+}
+
+argparse::ParsedArguments argparse::ArgumentSchema::parseStream(
+    std::istream &stream, const LoseArgumentHandler &loseArgument, std::size_t bufferSize,
+    std::pmr::memory_resource *resource) const
+{
+    return this->parseRecords([&stream](char *buffer, std::size_t size) -> long {
+        stream.read(buffer, static_cast<std::streamsize>(size));
+        return stream.bad() ? -1 : static_cast<long>(stream.gcount());
+    }, loseArgument, bufferSize, resource);
+}
+
+argparse::ParsedArguments argparse::ArgumentSchema::parseRecords(
+    const std::function<long(char*, std::size_t)> &read,
+    const LoseArgumentHandler &loseArgument, std::size_t bufferSize,
+    std::pmr::memory_resource *resource) const
+{
+    ParsedArguments parsed(resource);
+    parsed._schema = this;
+    parsed._slots.resize(this->definitions().size());
+
+    Matcher matcher(*this, parsed);
+    parsed._values = std::allocate_shared<ValueStorage>(std::pmr::polymorphic_allocator<ValueStorage>(resource));
+    matcher.copyValuesInto(parsed._values.get());
+    if (loseArgument)
+    {
+        matcher.setLoseArgumentHandler(&loseArgument);
+    }
+
+    if (!argparse::read_records(read, bufferSize, [&](std::string_view record) { matcher.feed(record); }, resource))
+    {
+        parsed._result = Result::StreamError;
+        return parsed;
+    }
+
+    parsed._result = matcher.finish();
+    return parsed;
+}
+
+const std::string argparse::ArgumentSchema::help(
+    bool visualizeStringOptions, const std::string &stringOptionSuffix,
+    std::uint8_t indentation, std::uint8_t spacing) const
+{
+    // don't do anything if there are no registered arguments
+    if (this->definitions().size() == 0 && this->_positionals.size() == 0 && this->_subcommands.size() == 0)
+    {
+        return "";
+    }
+
+    return argparse::format(
+        *this,
+        this->definitions(),
+        this->_positionals,
+        this->_subcommands,
+        visualizeStringOptions,
+        stringOptionSuffix,
+        indentation,
+        spacing,
+        this->_shortOptionPrefix,
+        this->_longOptionPrefix
+    );
+}
+
+void argparse::ArgumentSchema::enableAbbreviations(bool enable)
+{
+    this->_abbreviations = enable;
+    this->abbreviationTree.clear();
+
+    if (enable)
+    {
+        const auto definitions = this->definitions();
+        for (auto i = 0u; i < definitions.size(); ++i)
+        {
+            if (definitions[i].hasLongName())
+            {
+                this->abbreviationTree.insert(definitions[i].longName(), i);
+            }
+        }
+    }
+}
+
+std::size_t argparse::ArgumentSchema::findShortName(std::string_view name) const
+{
+    if (name.size() == 1)
+    {
+        return this->findShortCharacter(name[0]);
+    }
+
+    if (this->staticDefinitions)
+    {
+        const auto position = this->staticShortIndex.candidate(name);
+        return position < this->staticDefinitionsCount && this->staticDefinitions[position].shortName() == name ? position : npos;
+    }
+
+    const auto it = this->argumentsShortIndex.find(name);
+    return it != this->argumentsShortIndex.end() ? it->second : npos;
+}
+
+std::size_t argparse::ArgumentSchema::findLongName(std::string_view name) const
+{
+    if (this->staticDefinitions)
+    {
+        const auto position = this->staticLongIndex.candidate(name);
+        return position < this->staticDefinitionsCount && this->staticDefinitions[position].longName() == name ? position : npos;
+    }
+
+    const auto it = this->argumentsLongIndex.find(name);
+    return it != this->argumentsLongIndex.end() ? it->second : npos;
+}
+
+bool argparse::ArgumentSchema::addPositional(const std::string &name, const std::string &description, Positional::Arity arity)
+{
+    if (name.empty() || this->findPositional(name) != npos)
+    {
+        return false;
+    }
+
+    this->_positionals.emplace_back(name, description, arity);
+    return true;
+}
+
+std::size_t argparse::ArgumentSchema::findPositional(std::string_view name) const
+{
+    for (auto i = 0u; i < this->_positionals.size(); ++i)
+    {
+        if (this->_positionals[i].name() == name)
+        {
+            return i;
+        }
+    }
+
+    return npos;
+}
+
+bool argparse::ArgumentSchema::setEnvironmentVariable(std::string_view argument, const std::string &variable)
+{
+    const auto position = this->find(argument);
+    if (this->staticDefinitions || position == npos || variable.empty() || this->environmentIndex.count(variable) != 0)
+    {
+        return false;
+    }
+
+    auto &added = this->_arguments[position];
+    this->environmentIndex.erase(added.environmentVariable());
+    added.setEnvironmentVariable(variable);
+
+    this->_definitions[position] = added.definition();
+    this->environmentIndex.emplace(added.environmentVariable(), position);
+    return true;
+}
+
+bool argparse::ArgumentSchema::addSubcommand(const std::string &name, const std::string &description, Subcommand::Factory factory)
+{
+    if (name.empty() || !factory || this->subcommandIndex.count(name) != 0)
+    {
+        return false;
+    }
+
+    const auto &subcommand = this->_subcommands.emplace_back(name, description, std::move(factory));
+    this->subcommandIndex.emplace(subcommand.name(), this->_subcommands.size() - 1);
+    return true;
+}
+
+std::size_t argparse::ArgumentSchema::findSubcommand(std::string_view name) const
+{
+    const auto it = this->subcommandIndex.find(name);
+    return it != this->subcommandIndex.end() ? it->second : npos;
+}
+
+const argparse::ArgumentSchema *argparse::ArgumentSchema::subcommand(std::string_view name) const
+{
+    const auto position = this->findSubcommand(name);
+    if (position == npos)
+    {
+        return nullptr;
+    }
+
+    return &this->_subcommands[position].schema(*this);
+}
+
+argparse::Subcommand::Subcommand(const std::string &name, const std::string &description, Factory factory)
+    : _name(name),
+      _description(description),
+      _factory(std::move(factory))
+{
+}
+
+argparse::Subcommand::~Subcommand() = default;
+
+const argparse::ArgumentSchema &argparse::Subcommand::schema(const ArgumentSchema &parent) const
+{
+    std::call_once(this->once, [&]{
+        this->_schema = std::make_unique<ArgumentSchema>(parent.shortOptionPrefix(), parent.longOptionPrefix());
+        this->_schema->setTerminator(parent.terminator());
+        this->_factory(*this->_schema);
+        this->_created.store(true, std::memory_order_release);
+    });
+
+    return *this->_schema;
+}
+
+bool argparse::ArgumentSchema::addArgumentInternal(Argument argument)
+{
+    // reset state before adding
+    argument.reset();
+
+    // refuse to add invalid argument
+    if (!argument.isValid())
+    {
+        return false;
+    }
+
+    // check if already added
+    if (argument.hasLongName() && this->argumentsLongIndex.count(argument.longName()) != 0)
+    {
+        return false;
+    }
+    if (argument.hasShortName() && this->argumentsShortIndex.count(argument.shortName()) != 0)
+    {
+        return false;
+    }
+
+    // add copy to internal array, the definitions and the indices refer to the
+    // strings of the arguments and are rebuilt when the array was reallocated
+    const auto *storage = this->_arguments.data();
+    this->_arguments.emplace_back(std::move(argument));
+
+    if (this->_arguments.data() != storage)
+    {
+        this->indexArguments();
+    }
+    else
+    {
+        this->indexArgument(this->_arguments.size() - 1);
+    }
+    return true;
+}
+
+void argparse::ArgumentSchema::indexArgument(std::size_t position)
+{
+    const auto &added = this->_arguments[position];
+    this->_definitions.emplace_back(added.definition());
+    if (added.environmentVariable().size() > 0)
+    {
+        this->environmentIndex.emplace(added.environmentVariable(), position);
+    }
+    if (added.hasLongName())
+    {
+        this->argumentsLongIndex.emplace(added.longName(), position);
+        if (this->_abbreviations)
+        {
+            this->abbreviationTree.insert(added.longName(), position);
+        }
+    }
+    if (added.hasShortName())
+    {
+        this->argumentsShortIndex.emplace(added.shortName(), position);
+        if (added.shortName().size() == 1)
+        {
+            this->argumentsCharacterIndex[static_cast<unsigned char>(added.shortName()[0])] = static_cast<std::uint32_t>(position + 1);
+        }
+    }
+}
+
+void argparse::ArgumentSchema::indexArguments()
+{
+    this->_definitions.clear();
+    this->argumentsLongIndex.clear();
+    this->argumentsShortIndex.clear();
+    this->environmentIndex.clear();
+    this->abbreviationTree.clear();
+
+    for (auto i = 0u; i < this->_arguments.size(); ++i)
+    {
+        this->indexArgument(i);
+    }
+}
+
+void argparse::ArgumentSchema::reserve(std::size_t count)
+{
+    if (this->staticDefinitions || count <= this->_arguments.capacity())
+    {
+        return;
+    }
+
+    this->_arguments.reserve(count);
+    this->_definitions.reserve(count);
+    this->argumentsLongIndex.reserve(count);
+    this->argumentsShortIndex.reserve(count);
+    this->indexArguments();
+}
+
+std::vector<std::string_view> argparse::ParsedArguments::changes(const ParsedArguments &other) const
+{
+    std::vector<std::string_view> changed;
+    if (!this->_schema || this->_schema != other._schema)
+    {
+        return changed;
+    }
+
+    const auto definitions = this->_schema->definitions();
+    for (auto i = 0u; i < definitions.size(); ++i)
+    {
+        const auto &slot = this->_slots[i];
+        const auto &otherSlot = other._slots[i];
+
+        // the values of `Append` arguments, empty for other arguments
+        const auto appended = this->_appendedValues.data() + slot.appendedBegin;
+        const auto otherAppended = other._appendedValues.data() + otherSlot.appendedBegin;
+
+        if (slot.present != otherSlot.present || slot.value != otherSlot.value ||
+            !std::equal(appended, appended + slot.appendedCount, otherAppended, otherAppended + otherSlot.appendedCount))
+        {
+            changed.emplace_back(definitions[i].name());
+        }
+    }
+
+    return changed;
+}
+
+void argparse::ArgumentBindings::apply(const ParsedArguments &parsed) const
+{
+    if (parsed.result() != ArgumentParserResult::Success)
+    {
+        return;
+    }
+
+    for (auto&& binding : this->bindings)
+    {
+        binding.assign(binding.target, parsed, binding.position);
+    }
+}
+
+argparse::Span<const std::string_view> argparse::ParsedArguments::positionals(std::string_view name) const
+{
+    if (this->_result != Result::Success || !this->_schema)
+    {
+        return {};
+    }
+
+    const auto position = this->_schema->findPositional(name);
+    if (position == ArgumentSchema::npos)
+    {
+        return {};
+    }
+
+    const auto &range = this->_positionalRanges[position];
+    return Span<const std::string_view>(this->_positionalValues.data() + range.first, range.second);
+}
+
+bool argparse::ParsedArguments::exists(std::string_view name) const
+{
+    return this->existsAt(this->positionOf(name));
+}
+
+std::size_t argparse::ParsedArguments::positionOf(std::string_view name) const
+{
+    return this->_schema ? this->_schema->find(name) : npos;
+}
+
+bool argparse::ParsedArguments::existsAt(std::size_t position) const
+{
+    return this->_result == Result::Success && position < this->_slots.size() && this->_slots[position].present;
+}
+
+const argparse::ArgumentDefinition &argparse::ParsedArguments::definitionAt(std::size_t position) const
+{
+    return this->_schema->definitions()[position];
+}
@@ -0,0 +1,1086 @@
+#ifndef LIBARGPARSE_SCHEMA_HPP
+#define LIBARGPARSE_SCHEMA_HPP
+
+#include "argument.hpp"
+#include "command_line.hpp"
+#include "static_schema.hpp"
+#include "prefix_tree.hpp"
+#include "span.hpp"
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <memory_resource>
+#include <functional>
+#include <iosfwd>
+#include <string_view>
+#include <unordered_map>
+#include <limits>
+#include <type_traits>
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+namespace argparse {
+
+struct ArgumentSchema;
+struct MappedFile;
+struct Matcher;
+struct ArgumentBindings;
+struct ConfigWatcher;
+
+/**
+ * List of arguments in a parse result, allocated from the
+ * memory resource of the result.
+ */
+using StringList = std::pmr::vector<std::pmr::string>;
+
+/**
+ * Parsing result status codes.
+ */
+enum class ArgumentParserResult : unsigned short
+{
+    Success = 0,
+    InsufficientArguments,      // too less arguments given
+    MissingArgument,            // a required argument not provided
+    ResponseFileError,          // a response file can't be read or has an unterminated quote
+    ResponseFileNesting,        // response files are nested too deep
+    StreamError,                // the argument stream can't be read or has a record longer than the read buffer
+    AmbiguousArgument,          // an abbreviated option matches multiple arguments
+    ConfigFileError,            // the config file can't be read or has a line without `=`
+
+    Unknown = std::numeric_limits<unsigned short>::max(),
+};
+
+/**
+ * Typed value of a parsed argument, filled by the first typed read.
+ *
+ * Only trivially copyable types up to the size of a `long double` are cached,
+ * like numbers, durations and byte sizes, and only the first requested type
+ * of a slot, reads of other types are converted every time. The cache
+ * can be filled and read from multiple threads.
+ */
+struct TypedValue final
+{
+public:
+    template<typename T>
+    static constexpr bool cacheable =
+        std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T> && !std::is_same_v<T, bool> &&
+        sizeof(T) <= sizeof(long double) && alignof(T) <= alignof(long double);
+
+    TypedValue() = default;
+
+    TypedValue(const TypedValue &other)
+    {
+        *this = other;
+    }
+
+    TypedValue &operator=(const TypedValue &other)
+    {
+        if (other.state.load(std::memory_order_acquire) == Ready)
+        {
+            this->type = other.type;
+            this->ok = other.ok;
+            std::memcpy(this->storage, other.storage, sizeof(this->storage));
+            this->state.store(Ready, std::memory_order_release);
+        }
+        else
+        {
+            this->state.store(Empty, std::memory_order_release);
+        }
+        return *this;
+    }
+
+    /**
+     * Returns true and sets `result` if a value of type `T` is cached.
+     */
+    template<typename T>
+    bool load(std::optional<T> &result) const
+    {
+        static_assert(cacheable<T>);
+        if (this->state.load(std::memory_order_acquire) != Ready || this->type != type_id<T>())
+        {
+            return false;
+        }
+
+        result = std::nullopt;
+        if (this->ok)
+        {
+            T value;
+            std::memcpy(&value, this->storage, sizeof(T));
+            result = value;
+        }
+        return true;
+    }
+
+    /**
+     * Caches the converted value, does nothing if a value was already cached.
+     */
+    template<typename T>
+    void store(const std::optional<T> &result) const
+    {
+        static_assert(cacheable<T> && sizeof(T) <= sizeof(storage));
+        std::uint8_t expected = Empty;
+        if (!this->state.compare_exchange_strong(expected, Writing, std::memory_order_acquire))
+        {
+            return;
+        }
+
+        this->type = type_id<T>();
+        this->ok = result.has_value();
+        if (this->ok)
+        {
+            std::memcpy(this->storage, &result.value(), sizeof(T));
+        }
+        this->state.store(Ready, std::memory_order_release);
+    }
+
+private:
+    // unique address per type, RTTI is disabled
+    template<typename T>
+    static const void *type_id()
+    {
+        static const char id = 0;
+        return &id;
+    }
+
+    enum : std::uint8_t
+    {
+        Empty,
+        Writing,
+        Ready,
+    };
+
+    mutable std::atomic<std::uint8_t> state{Empty};
+    mutable const void *type = nullptr;
+    mutable bool ok = false;
+    alignas(long double) mutable unsigned char storage[sizeof(long double)] = {};
+};
+
+/**
+ * Position of an argument in its schema with the type its value is read as,
+ * returned by `ArgumentSchema::addTypedArgument()` and `ArgumentSchema::handle()`.
+ *
+ * Reading a result through a handle accesses the slot directly without looking
+ * up the name. A handle is only meaningful for results of the schema it came from.
+ */
+template<typename T = std::string>
+struct ArgumentHandle final
+{
+public:
+    using Type = T;
+
+    constexpr ArgumentHandle() = default;
+
+    constexpr explicit ArgumentHandle(std::size_t position)
+        : _position(position)
+    {
+    }
+
+    constexpr std::size_t position() const
+    {
+        return this->_position;
+    }
+
+    /**
+     * Invalid handles are returned for arguments which couldn't be added or found,
+     * reading them behaves like reading an unknown name.
+     */
+    constexpr bool isValid() const
+    {
+        return this->_position != static_cast<std::size_t>(-1);
+    }
+
+private:
+    std::size_t _position = static_cast<std::size_t>(-1);
+};
+
+/**
+ * Result of parsing a command line against an `ArgumentSchema`.
+ *
+ * The result references the schema and the parsed command line,
+ * both must outlive it. Response files are owned by the result.
+ */
+struct ParsedArguments final
+{
+public:
+    using Result = ArgumentParserResult;
+
+    /**
+     * Parsing state of a single registered argument.
+     */
+    struct Slot final
+    {
+        bool present = false;
+        std::optional<std::string_view> value;
+        TypedValue typed;
+
+        // values of an `Append` argument in the appended values
+        std::uint32_t appendedBegin = 0;
+        std::uint32_t appendedCount = 0;
+    };
+
+    using Slots = std::pmr::vector<Slot>;
+    using StringList = argparse::StringList;
+
+    // response and config files the parsed values refer to
+    using ResponseFiles = std::pmr::vector<std::shared_ptr<const MappedFile>>;
+
+    // values of streamed arguments
+    using Values = std::pmr::deque<std::pmr::string>;
+
+    // values of all `Append` arguments, grouped by argument
+    using AppendedValues = std::pmr::vector<std::string_view>;
+
+    // values of all positional arguments in command line order
+    using PositionalValues = std::pmr::vector<std::string_view>;
+
+    // first value and number of values of every positional argument
+    using PositionalRanges = std::pmr::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+    /**
+     * Creates an empty result, everything the result stores is allocated
+     * from the given memory resource.
+     */
+    explicit ParsedArguments(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : _slots(resource),
+          _appendedValues(resource),
+          _positionalValues(resource),
+          _positionalCache(resource),
+          _positionalRanges(resource),
+          _responseFiles(resource),
+          _missingArguments(resource),
+          _ambiguousArguments(resource),
+          _loseArguments(resource),
+          _remainingArguments(resource)
+    {
+    }
+
+    inline std::pmr::memory_resource *resource() const
+    {
+        return this->_slots.get_allocator().resource();
+    }
+
+    /**
+     * The parsing status.
+     */
+    inline Result result() const
+    {
+        return this->_result;
+    }
+
+    /**
+     * Returns a list of missing arguments.
+     */
+    inline const StringList &missingArguments() const
+    {
+        return this->_missingArguments;
+    }
+
+    /**
+     * Returns a list of abbreviated options which match multiple arguments.
+     */
+    inline const StringList &ambiguousArguments() const
+    {
+        return this->_ambiguousArguments;
+    }
+
+    /**
+     * Returns a list of all lose arguments which didn't belong to an string option.
+     */
+    inline const StringList &loseArguments() const
+    {
+        return this->_loseArguments;
+    }
+
+    /**
+     * Returns a list of all remaining arguments which weren't parsed
+     * due to termination.
+     */
+    inline const StringList &remainingArguments() const
+    {
+        return this->_remainingArguments;
+    }
+
+    /**
+     * Is the given argument present on the command line?
+     */
+    bool exists(std::string_view name) const;
+
+    template<typename T>
+    inline bool exists(ArgumentHandle<T> handle) const
+    {
+        return this->existsAt(handle.position());
+    }
+
+    /**
+     * Returns the names of the arguments whose presence or values differ
+     * from another result of the same schema.
+     */
+    std::vector<std::string_view> changes(const ParsedArguments &other) const;
+
+    /**
+     * Returns the parsed value of the given argument.
+     *
+     * See `ArgumentParser::get()` for details.
+     */
+    template<typename T = std::string>
+    auto get(std::string_view name, bool *ok = nullptr) const
+    {
+        return this->getAt<T>(this->positionOf(name), ok);
+    }
+
+    /**
+     * Returns the parsed value of the argument of the handle as the type of the handle.
+     */
+    template<typename T>
+    inline T get(ArgumentHandle<T> handle, bool *ok = nullptr) const
+    {
+        return this->getAt<T>(handle.position(), ok);
+    }
+
+    /**
+     * Returns all values of the given positional argument in command line order.
+     */
+    Span<const std::string_view> positionals(std::string_view name) const;
+
+    /**
+     * Result of the selected subcommand or `nullptr` if no subcommand was selected,
+     * it has the arguments after the subcommand name.
+     */
+    inline const ParsedArguments *subcommand() const
+    {
+        return this->_subcommand.get();
+    }
+
+    /**
+     * Name of the selected subcommand, empty if no subcommand was selected.
+     */
+    inline std::string_view subcommandName() const
+    {
+        return this->_subcommandName;
+    }
+
+    /**
+     * Returns the value at the given index of the given positional argument.
+     *
+     * See `ArgumentParser::positional()` for details.
+     */
+    template<typename T = std::string>
+    T positional(std::string_view name, std::size_t index = 0, bool *ok = nullptr) const
+    {
+        const auto values = this->positionals(name);
+        if (index >= values.size())
+        {
+            if (ok) *ok = false;
+            return T{};
+        }
+
+        const auto position = static_cast<std::size_t>(&values[index] - this->_positionalValues.data());
+        return convert<T>(this->_positionalCache[position], values[index], ok);
+    }
+
+    /**
+     * Returns all values of an `Append` argument in command line order.
+     *
+     * See `ArgumentParser::getAll()` for details.
+     */
+    template<typename T = std::string_view>
+    auto getAll(std::string_view name, bool *ok = nullptr) const
+    {
+        return this->getAllAt<T>(this->positionOf(name), ok);
+    }
+
+private:
+    friend argparse::ArgumentSchema;
+    friend argparse::ArgumentBindings;
+    friend argparse::Matcher;
+
+    // same as `ArgumentSchema::npos`, which isn't declared yet
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    template<typename T>
+    auto getAllAt(std::size_t position, bool *ok) const
+    {
+        Span<const std::string_view> values;
+
+        const Slot *slot = this->_result == Result::Success && position < this->_slots.size() ? &this->_slots[position] : nullptr;
+        if (slot)
+        {
+            values = Span<const std::string_view>(this->_appendedValues.data() + slot->appendedBegin, slot->appendedCount);
+        }
+        if (ok) *ok = slot != nullptr;
+
+        if constexpr (std::is_same_v<T, std::string_view>)
+        {
+            return values;
+        }
+        else
+        {
+            std::vector<T> converted;
+            converted.reserve(values.size());
+            for (auto&& value : values)
+            {
+                const auto result = Argument::convert_helper<T>(value);
+                if (!result.has_value() && ok) *ok = false;
+                converted.emplace_back(result.has_value() ? result.value() : T{});
+            }
+            return converted;
+        }
+    }
+
+    // position of the argument with the given name or `npos`
+    std::size_t positionOf(std::string_view name) const;
+
+    // the position may be out of range for unknown arguments
+    bool existsAt(std::size_t position) const;
+
+    template<typename T>
+    T getAt(std::size_t position, bool *ok) const
+    {
+        if (this->_result != Result::Success)
+        {
+            if (ok) *ok = false;
+            return T{};
+        }
+
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            if (ok) *ok = true;
+            return this->existsAt(position);
+        }
+        else
+        {
+            if (position >= this->_slots.size() || !this->_slots[position].present)
+            {
+                if (ok) *ok = false;
+                return T{};
+            }
+
+            const auto &slot = this->_slots[position];
+            const auto value = slot.value.has_value() ? slot.value : this->definitionAt(position).defaultValue();
+            return convert<T>(slot.typed, value, ok);
+        }
+    }
+
+    const ArgumentDefinition &definitionAt(std::size_t position) const;
+
+    // convert a value, repeated reads of numbers are served from the cache
+    template<typename T>
+    static T convert(const TypedValue &typed, std::optional<std::string_view> value, bool *ok)
+    {
+        std::optional<T> result = std::nullopt;
+
+        if constexpr (TypedValue::cacheable<T>)
+        {
+            if (typed.load(result))
+            {
+                if (ok) *ok = result.has_value();
+                return result.has_value() ? result.value() : T{};
+            }
+        }
+
+        if (value.has_value())
+        {
+            result = Argument::convert_helper<T>(value.value());
+        }
+
+        if constexpr (TypedValue::cacheable<T>)
+        {
+            typed.store(result);
+        }
+
+        if (ok) *ok = result.has_value();
+        return result.has_value() ? result.value() : T{};
+    }
+
+    const ArgumentSchema *_schema = nullptr;
+    Result _result = Result::Unknown;
+
+    Slots _slots;
+    AppendedValues _appendedValues;
+
+    // the conversion cache has an entry per positional value
+    PositionalValues _positionalValues;
+    std::pmr::vector<TypedValue> _positionalCache;
+    PositionalRanges _positionalRanges;
+
+    // result of the selected subcommand, its name is a view into the schema
+    std::shared_ptr<const ParsedArguments> _subcommand;
+    std::string_view _subcommandName;
+
+    ResponseFiles _responseFiles;
+
+    // values of streamed arguments, which are gone after parsing,
+    // shared like the response files so copies of the result stay valid
+    std::shared_ptr<Values> _values;
+
+    StringList _missingArguments;
+    StringList _ambiguousArguments;
+    StringList _loseArguments;
+    StringList _remainingArguments;
+};
+
+/**
+ * Variables which receive the values of arguments from a parse result,
+ * like the members of a configuration struct.
+ *
+ * Every value is converted once through the conversion cache of the result
+ * and written into its variable, without looking up a name. Variables of
+ * arguments which aren't present or whose values can't be converted keep
+ * their value. `bool` variables receive the presence of the argument and
+ * `std::vector<T>` variables all values of an `Append` argument.
+ */
+struct ArgumentBindings final
+{
+public:
+    /**
+     * Binds the argument at the given position of the schema to the variable,
+     * which must outlive the bindings.
+     */
+    template<typename T>
+    inline void bind(std::size_t position, T *target)
+    {
+        this->bindings.push_back(Binding{position, target, &ArgumentBindings::assign<T>});
+    }
+
+    inline bool empty() const
+    {
+        return this->bindings.empty();
+    }
+
+    /**
+     * Writes the values of a successful result into the bound variables.
+     */
+    void apply(const ParsedArguments &parsed) const;
+
+private:
+    template<typename T>
+    struct is_vector : std::false_type {};
+
+    template<typename T>
+    struct is_vector<std::vector<T>> : std::true_type {};
+
+    template<typename T>
+    static void assign(void *target, const ParsedArguments &parsed, std::size_t position)
+    {
+        bool ok = false;
+
+        if constexpr (is_vector<T>::value)
+        {
+            auto values = parsed.getAllAt<typename T::value_type>(position, &ok);
+            if (ok && parsed.existsAt(position))
+            {
+                *static_cast<T*>(target) = T(values.begin(), values.end());
+            }
+        }
+        else
+        {
+            auto value = parsed.getAt<T>(position, &ok);
+            if (ok)
+            {
+                *static_cast<T*>(target) = std::move(value);
+            }
+        }
+    }
+
+    using Assign = void (*)(void *target, const ParsedArguments &parsed, std::size_t position);
+
+    struct Binding final
+    {
+        std::size_t position;
+        void *target;
+        Assign assign;
+    };
+
+    std::vector<Binding> bindings;
+};
+
+/**
+ * Subcommand of an `ArgumentSchema`, like `commit` in `git commit`.
+ *
+ * The subcommand has a schema of its own, whose arguments are registered by
+ * a factory. The schema is only created when the subcommand is selected on
+ * a command line or when it is requested.
+ */
+struct Subcommand final
+{
+public:
+    // registers the arguments of the subcommand
+    using Factory = std::function<void(ArgumentSchema &schema)>;
+
+    Subcommand(const std::string &name, const std::string &description, Factory factory);
+    ~Subcommand();
+
+    Subcommand(const Subcommand &) = delete;
+    Subcommand &operator=(const Subcommand &) = delete;
+
+    inline const std::string &name() const
+    {
+        return this->_name;
+    }
+
+    inline const std::string &description() const
+    {
+        return this->_description;
+    }
+
+    /**
+     * Was the schema already created?
+     */
+    inline bool created() const
+    {
+        return this->_created.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns the schema of the subcommand, which is created by the factory on the
+     * first call. It has the option prefixes and the terminator of the parent schema.
+     * Can be called from multiple threads, the factory runs only once.
+     */
+    const ArgumentSchema &schema(const ArgumentSchema &parent) const;
+
+private:
+    std::string _name;
+    std::string _description;
+    Factory _factory;
+
+    mutable std::once_flag once;
+    mutable std::unique_ptr<ArgumentSchema> _schema;
+    mutable std::atomic<bool> _created{false};
+};
+
+/**
+ * A set of argument definitions which can parse any number of command lines.
+ *
+ * Once all arguments are registered, the schema can be shared read-only
+ * between threads, `parse()` doesn't modify it.
+ */
+struct ArgumentSchema final
+{
+public:
+    using Result = ArgumentParserResult;
+
+    using Arguments = std::vector<Argument>;
+    using Definitions = Span<const ArgumentDefinition>;
+    using Positionals = std::vector<Positional>;
+
+    // subcommands don't move, the index refers to their names
+    using Subcommands = std::deque<Subcommand>;
+
+    // maps an option name to the position of its argument, keys are views into the argument names
+    using ArgumentIndex = std::unordered_map<std::string_view, std::size_t>;
+
+    // receives lose arguments of streamed command lines
+    using LoseArgumentHandler = std::function<void(std::string_view)>;
+
+    // returned by the lookup functions when the name isn't registered
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    ArgumentSchema(const std::string &shortOptionPrefix = "-", const std::string &longOptionPrefix = "--");
+
+    ArgumentSchema(const ArgumentSchema &) = delete; // the index refers to its own arguments
+
+    /**
+     * Creates a schema from definitions which are known at compile time,
+     * see `makeStaticSchema()`. The schema uses the compile-time tables
+     * directly, nothing is copied or indexed at runtime.
+     *
+     * Arguments can't be added to such a schema.
+     */
+    template<const auto &Schema>
+    static ArgumentSchema fromStatic(const std::string &shortOptionPrefix = "-", const std::string &longOptionPrefix = "--")
+    {
+        static_assert(Schema.isValid(), "static schema contains an argument without name or duplicate names");
+        return ArgumentSchema(Schema, shortOptionPrefix, longOptionPrefix);
+    }
+
+    /**
+     * Adds a new argument to the schema.
+     *
+     * If only one parameter is given it is assumed it is of type `Argument`.
+     * If multiple parameters are given, they are forwarded to the `Argument` constructor.
+     */
+    template<typename... Args>
+    inline bool addArgument(Args&&... args)
+    {
+        if (this->staticDefinitions) return false;
+
+        if constexpr (sizeof...(args) == 1)
+        {
+            return this->addArgumentInternal(args...);
+        }
+        else
+        {
+            return this->addArgumentInternal(Argument(args...));
+        }
+    }
+
+    /**
+     * Lets the given argument fall back to the value of an environment variable when
+     * it isn't on the command line, the variable takes precedence over the default value.
+     * Boolean switches are enabled by any value but an empty one, `0` and `false`.
+     *
+     * Returns false if there is no such argument, the variable is used by another
+     * argument or the schema is static, use `ArgumentDefinition::withEnvironmentVariable()` there.
+     */
+    bool setEnvironmentVariable(std::string_view argument, const std::string &variable);
+
+    /**
+     * Adds a positional argument, which takes the values that don't belong to an
+     * option. Values which aren't taken by any positional argument are lose arguments.
+     *
+     * Returns false if the name is empty or already used by another positional argument.
+     */
+    bool addPositional(const std::string &name, const std::string &description, Positional::Arity arity = Positional::One);
+
+    /**
+     * Adds a subcommand, like `commit` in `git commit`. The first value on a command line
+     * which is the name of a subcommand selects it, the following arguments are parsed
+     * against the schema of the subcommand and stored in `ParsedArguments::subcommand()`.
+     *
+     * The factory registers the arguments of the subcommand on its schema, it only runs
+     * when the subcommand is selected or its schema is requested with `subcommand()`.
+     * Adding a subcommand costs the same no matter how many arguments it has.
+     *
+     * Returns false if the name is empty or already used by another subcommand.
+     */
+    bool addSubcommand(const std::string &name, const std::string &description, Subcommand::Factory factory);
+
+    /**
+     * Returns the schema of the given subcommand, for example to render its help,
+     * `nullptr` if there is no such subcommand. The schema is created on the first call.
+     */
+    const ArgumentSchema *subcommand(std::string_view name) const;
+
+    /**
+     * Reserves memory for the given number of arguments, which avoids
+     * reindexing the registered arguments while adding more of them.
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * Adds a new argument like `addArgument()` and returns a handle to read its value
+     * as the given type, which is invalid if the argument couldn't be added.
+     */
+    template<typename T = std::string, typename... Args>
+    inline ArgumentHandle<T> addTypedArgument(Args&&... args)
+    {
+        return this->addArgument(std::forward<Args>(args)...) ?
+            ArgumentHandle<T>(this->definitions().size() - 1) : ArgumentHandle<T>();
+    }
+
+    /**
+     * Returns a handle to read the value of the argument with the given long or
+     * short name as the given type, which is invalid for unknown names.
+     */
+    template<typename T = std::string>
+    inline ArgumentHandle<T> handle(std::string_view name) const
+    {
+        const auto position = this->find(name);
+        return position != npos ? ArgumentHandle<T>(position) : ArgumentHandle<T>();
+    }
+
+    /**
+     * Convenience function to add a help option.
+     * Only the description must be provided.
+     */
+    inline bool addHelpOption(const std::string &description)
+    {
+        return this->addArgument(Argument("h", "help", description, Argument::Boolean, false));
+    }
+
+    /**
+     * Enables command line parsing termination.
+     * Defaults to `--`.
+     */
+    inline void setTerminator(const std::string &terminator = "--")
+    {
+        this->_terminator = terminator;
+    }
+
+    /**
+     * Accepts unique prefixes of long option names, `--verb` for `--verbose`.
+     * Exact names always win, prefixes which match multiple arguments are reported
+     * as `AmbiguousArgument`. The lookup is backed by a radix tree of all long names.
+     */
+    void enableAbbreviations(bool enable = true);
+
+    /**
+     * Enables `@file` response files. Such arguments are replaced with the
+     * whitespace separated arguments inside the file, which may contain shell-like
+     * quoting and escaping and can reference other response files up to the given depth.
+     * Passing zero disables response files again.
+     */
+    inline void enableResponseFiles(std::uint8_t maxDepth = 8)
+    {
+        this->_responseFileDepth = maxDepth;
+    }
+
+    /**
+     * Parses the given command line. The first argument is the
+     * application and is skipped.
+     *
+     * Everything the result stores is allocated from the given memory resource,
+     * like a `std::pmr::monotonic_buffer_resource` which is released after the request.
+     */
+    ParsedArguments parse(const CommandLine &commandLine, std::pmr::memory_resource *resource = std::pmr::get_default_resource()) const;
+
+    inline ParsedArguments parse(const std::vector<std::string> &args, std::pmr::memory_resource *resource = std::pmr::get_default_resource()) const
+    {
+        return this->parse(CommandLine(args), resource);
+    }
+
+    /**
+     * Parses the given command line with a `key = value` config file as fallback.
+     * Keys are long option names without the prefix, `[section]` headers and lines
+     * starting with `#` or `;` are skipped and keys of unknown arguments are ignored.
+     *
+     * Arguments on the command line and in the environment take precedence over the
+     * config file. Every line of an `Append` argument appends a value, for other
+     * arguments the last line wins. The file is memory-mapped and the values are views
+     * into it, so reading it doesn't allocate per line.
+     */
+    ParsedArguments parse(
+        const CommandLine &commandLine, const std::string &configFile,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource()) const;
+
+    inline ParsedArguments parse(
+        const std::vector<std::string> &args, const std::string &configFile,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource()) const
+    {
+        return this->parse(CommandLine(args), configFile, resource);
+    }
+
+    /**
+     * Parses NUL separated arguments from a file descriptor or stream, like the
+     * output of `find -print0` or `/proc/<pid>/cmdline`. Every record is an argument,
+     * the first one isn't skipped.
+     *
+     * The arguments are read through a buffer of the given size and matched one by one,
+     * so the memory usage doesn't depend on the input size when the lose arguments are
+     * passed to `loseArgument` instead of being stored in the result. Option values
+     * are copied into the result, a repeated option overwrites its copy and only
+     * `Append` options keep every value. Values of positional arguments are stored
+     * too, a variadic positional argument takes all values which aren't options.
+     * Response files aren't expanded. The read buffer
+     * and the result are allocated from the given memory resource.
+     */
+    ParsedArguments parseStream(
+        int fd, const LoseArgumentHandler &loseArgument = {}, std::size_t bufferSize = 64 * 1024,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource()) const;
+
+    ParsedArguments parseStream(
+        std::istream &stream, const LoseArgumentHandler &loseArgument = {}, std::size_t bufferSize = 64 * 1024,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource()) const;
+
+    /**
+     * Formats a string for printing all registered command line arguments
+     * and their description in a pretty way.
+     *
+     * See `ArgumentParser::help()` for details.
+     */
+    const std::string help(
+        bool visualizeStringOptions, const std::string &stringOptionSuffix = " [value]",
+        std::uint8_t indentation = 4, std::uint8_t spacing = 10) const;
+
+    /**
+     * Definitions of all registered arguments in order of registration,
+     * the position of a definition is the position of its result slot.
+     */
+    inline Definitions definitions() const
+    {
+        if (this->staticDefinitions)
+        {
+            return Definitions(this->staticDefinitions, this->staticDefinitionsCount);
+        }
+        return Definitions(this->_definitions.data(), this->_definitions.size());
+    }
+
+    /**
+     * Positional arguments in order of registration.
+     */
+    inline const Positionals &positionals() const
+    {
+        return this->_positionals;
+    }
+
+    /**
+     * Returns the position of the positional argument with the given name or `npos`.
+     */
+    std::size_t findPositional(std::string_view name) const;
+
+    /**
+     * Returns the position of the argument whose value falls back to the
+     * given environment variable or `npos`.
+     */
+    inline std::size_t findEnvironmentVariable(std::string_view name) const
+    {
+        const auto it = this->environmentIndex.find(name);
+        return it != this->environmentIndex.end() ? it->second : npos;
+    }
+
+    /**
+     * Does any argument fall back to an environment variable?
+     */
+    inline bool hasEnvironmentVariables() const
+    {
+        return this->environmentIndex.size() > 0;
+    }
+
+    /**
+     * Subcommands in order of registration.
+     */
+    inline const Subcommands &subcommands() const
+    {
+        return this->_subcommands;
+    }
+
+    /**
+     * Returns the position of the subcommand with the given name or `npos`.
+     */
+    std::size_t findSubcommand(std::string_view name) const;
+
+    /**
+     * Returns the position of the argument with the given short name or `npos`.
+     */
+    std::size_t findShortName(std::string_view name) const;
+
+    /**
+     * Returns the position of the argument with the given single character short name or `npos`.
+     */
+    inline std::size_t findShortCharacter(char name) const
+    {
+        const auto &index = this->staticCharacterIndex ? *this->staticCharacterIndex : this->argumentsCharacterIndex;
+        return static_cast<std::size_t>(index[static_cast<unsigned char>(name)]) - 1;
+    }
+
+    /**
+     * Returns the position of the argument with the given long name or `npos`.
+     */
+    std::size_t findLongName(std::string_view name) const;
+
+    /**
+     * Returns the position of the argument with the given long name or the only
+     * long name starting with it, `npos` if there is none or if abbreviations are
+     * disabled. `ambiguous` is set if multiple names start with it.
+     */
+    inline std::size_t findAbbreviation(std::string_view prefix, bool &ambiguous) const
+    {
+        ambiguous = false;
+        return this->_abbreviations ? this->abbreviationTree.find(prefix, ambiguous) : npos;
+    }
+
+    /**
+     * Returns the position of the argument with the given long or short name or `npos`.
+     */
+    inline std::size_t find(std::string_view name) const
+    {
+        const auto position = this->findLongName(name);
+        return position != npos ? position : this->findShortName(name);
+    }
+
+    inline const std::string &shortOptionPrefix() const
+    {
+        return this->_shortOptionPrefix;
+    }
+
+    inline const std::string &longOptionPrefix() const
+    {
+        return this->_longOptionPrefix;
+    }
+
+    inline const std::string &terminator() const
+    {
+        return this->_terminator;
+    }
+
+    inline std::uint8_t responseFileDepth() const
+    {
+        return this->_responseFileDepth;
+    }
+
+private:
+    template<std::size_t N>
+    ArgumentSchema(const StaticSchema<N> &schema, const std::string &shortOptionPrefix, const std::string &longOptionPrefix)
+        : staticDefinitions(schema.definitions.data()),
+          staticDefinitionsCount(N),
+          staticShortIndex(schema.shortIndex.view()),
+          staticLongIndex(schema.longIndex.view()),
+          staticCharacterIndex(&schema.characterIndex),
+          _shortOptionPrefix(shortOptionPrefix),
+          _longOptionPrefix(longOptionPrefix)
+    {
+        for (auto i = 0u; i < N; ++i)
+        {
+            if (schema.definitions[i].hasEnvironmentVariable())
+            {
+                this->environmentIndex.emplace(schema.definitions[i].environmentVariable(), i);
+            }
+        }
+    }
+
+    // arguments registered at runtime and views of their definitions, the
+    // definitions and indices are rebuilt when the arguments are reallocated
+    Arguments _arguments;
+    std::vector<ArgumentDefinition> _definitions;
+
+    // name lookup tables, filled on registration
+    ArgumentIndex argumentsLongIndex;
+    ArgumentIndex argumentsShortIndex;
+    CharacterIndex argumentsCharacterIndex{};
+
+    // environment variable names of the arguments, for static schemas too
+    ArgumentIndex environmentIndex;
+
+    // positional arguments, there are only a few of them so they are searched linearly
+    Positionals _positionals;
+
+    // subcommands and their names, the keys are views into the names
+    Subcommands _subcommands;
+    ArgumentIndex subcommandIndex;
+
+    // long names for abbreviations, only filled when they are enabled
+    bool _abbreviations = false;
+    PrefixTree abbreviationTree;
+
+    // compile-time definitions and tables, used instead of the above when set
+    const ArgumentDefinition *staticDefinitions = nullptr;
+    std::size_t staticDefinitionsCount = 0;
+    PerfectHashView staticShortIndex;
+    PerfectHashView staticLongIndex;
+    const CharacterIndex *staticCharacterIndex = nullptr;
+
+    std::string _shortOptionPrefix = "-";
+    std::string _longOptionPrefix = "--";
+    std::string _terminator = "";
+    std::uint8_t _responseFileDepth = 0;
+
+private:
+    bool addArgumentInternal(Argument argument);
+
+    // add the definition and the index entries of a registered argument
+    void indexArgument(std::size_t position);
+    void indexArguments();
+
+    ParsedArguments parseRecords(
+        const std::function<long(char*, std::size_t)> &read,
+        const LoseArgumentHandler &loseArgument, std::size_t bufferSize,
+        std::pmr::memory_resource *resource) const;
+
+    friend argparse::ConfigWatcher;
+
+    // the config file is optional, `configContent` replaces it with a
+    // copy which was read before, a null copy is an empty file
+    ParsedArguments parseCommandLine(
+        const CommandLine &commandLine, const std::string *configFile,
+        const std::shared_ptr<const MappedFile> *configContent,
+        std::pmr::memory_resource *resource) const;
+};
+
+} // namespace argparse
+
+#endif // LIBARGPARSE_SCHEMA_HPP
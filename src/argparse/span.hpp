@@ -0,0 +1,58 @@
+#ifndef LIBARGPARSE_SPAN_HPP
+#define LIBARGPARSE_SPAN_HPP
+
+#include <cstddef>
+
+namespace argparse {
+
+/**
+ * Non-owning view over a contiguous sequence of elements.
+ */
+template<typename T>
+struct Span final
+{
+public:
+    constexpr Span() = default;
+
+    constexpr Span(T *data, std::size_t size)
+        : _data(data),
+          _size(size)
+    {
+    }
+
+    constexpr T *begin() const
+    {
+        return this->_data;
+    }
+
+    constexpr T *end() const
+    {
+        return this->_data + this->_size;
+    }
+
+    constexpr std::size_t size() const
+    {
+        return this->_size;
+    }
+
+    constexpr bool empty() const
+    {
+        return this->_size == 0;
+    }
+
+    /**
+     * no bounds checking is done
+     */
+    constexpr T &operator[](std::size_t i) const
+    {
+        return this->_data[i];
+    }
+
+private:
+    T *_data = nullptr;
+    std::size_t _size = 0;
+};
+
+} // namespace argparse
+
+#endif // LIBARGPARSE_SPAN_HPP
@@ -0,0 +1,280 @@
+#ifndef LIBARGPARSE_STATIC_SCHEMA_HPP
+#define LIBARGPARSE_STATIC_SCHEMA_HPP
+
+#include "argument.hpp"
+
+#include <array>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+namespace argparse {
+
+/**
+ * hash function shared by the compile-time tables and the runtime lookup,
+ * FNV-1a with a seed mixed into the offset basis and a final avalanche step
+ */
+constexpr std::uint64_t hash_name(std::string_view name, std::uint64_t seed)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ull ^ (seed * 0x9e3779b97f4a7c15ull);
+    for (const char c : name)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ull;
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * Type erased view of a `PerfectHashTable`.
+ *
+ * A name is hashed into a bucket which holds the seed for the second hash,
+ * the second hash points to the only slot the name can be stored at.
+ */
+struct PerfectHashView final
+{
+    const std::uint32_t *seeds = nullptr;
+    const std::uint32_t *entries = nullptr; // argument position + 1, zero for empty slots
+    std::size_t mask = 0;
+
+    /**
+     * returns the argument position of the candidate for the given name,
+     * the caller must compare the name as unknown names map to any slot
+     */
+    constexpr std::size_t candidate(std::string_view name) const
+    {
+        if (!this->entries)
+        {
+            return static_cast<std::size_t>(-1);
+        }
+
+        const auto seed = this->seeds[hash_name(name, 0) & this->mask];
+        return static_cast<std::size_t>(this->entries[hash_name(name, seed) & this->mask]) - 1;
+    }
+};
+
+/**
+ * Perfect hash table over either the short or the long names
+ * of `N` argument definitions, built at compile time.
+ */
+template<std::size_t N>
+struct PerfectHashTable final
+{
+public:
+    // at most half of the slots are used, which keeps the seed search short
+    static constexpr std::size_t size = []{
+        std::size_t size = 1;
+        while (size < N * 2)
+        {
+            size *= 2;
+        }
+        return size;
+    }();
+
+    constexpr PerfectHashTable(const std::array<ArgumentDefinition, N> &definitions, bool shortNames)
+    {
+        constexpr auto mask = size - 1;
+
+        const auto name_of = [&](std::size_t i) {
+            return shortNames ? definitions[i].shortName() : definitions[i].longName();
+        };
+
+        // group the names by their first level bucket (counting sort),
+        // members of bucket `b` are `members[bucketStart[b] .. bucketStart[b + 1]]`
+        std::array<std::size_t, size + 1> bucketStart{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            if (name_of(i).size() > 0)
+            {
+                ++bucketStart[(hash_name(name_of(i), 0) & mask) + 1];
+            }
+        }
+        for (std::size_t b = 0; b < size; ++b)
+        {
+            bucketStart[b + 1] += bucketStart[b];
+        }
+
+        std::array<std::size_t, N> members{};
+        std::array<std::size_t, size> filled{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            if (name_of(i).size() > 0)
+            {
+                const auto bucket = hash_name(name_of(i), 0) & mask;
+                members[bucketStart[bucket] + filled[bucket]++] = i;
+            }
+        }
+
+        // equal names always share a bucket and never separate, leave the table empty
+        for (std::size_t b = 0; b < size; ++b)
+        {
+            for (auto i = bucketStart[b]; i < bucketStart[b + 1]; ++i)
+            {
+                for (auto j = i + 1; j < bucketStart[b + 1]; ++j)
+                {
+                    if (name_of(members[i]) == name_of(members[j]))
+                    {
+                        this->duplicates = true;
+                        return;
+                    }
+                }
+            }
+        }
+
+        // place the largest buckets first while most slots are free
+        std::size_t largest = 0;
+        for (std::size_t b = 0; b < size; ++b)
+        {
+            if (bucketStart[b + 1] - bucketStart[b] > largest)
+            {
+                largest = bucketStart[b + 1] - bucketStart[b];
+            }
+        }
+
+        std::array<std::size_t, size> order{};
+        std::size_t ordered = 0;
+        for (std::size_t bucketSize = largest; bucketSize > 0; --bucketSize)
+        {
+            for (std::size_t b = 0; b < size; ++b)
+            {
+                if (bucketStart[b + 1] - bucketStart[b] == bucketSize)
+                {
+                    order[ordered++] = b;
+                }
+            }
+        }
+
+        // find a seed for every bucket which moves all its names into free slots
+        std::array<bool, size> used{};
+        for (std::size_t o = 0; o < ordered; ++o)
+        {
+            const auto bucket = order[o];
+            for (std::uint32_t seed = 1; seed != 0; ++seed)
+            {
+                bool fits = true;
+                for (auto i = bucketStart[bucket]; i < bucketStart[bucket + 1] && fits; ++i)
+                {
+                    const auto slot = hash_name(name_of(members[i]), seed) & mask;
+                    fits = !used[slot];
+                    for (auto k = bucketStart[bucket]; k < i && fits; ++k)
+                    {
+                        fits = (hash_name(name_of(members[k]), seed) & mask) != slot;
+                    }
+                }
+
+                if (fits)
+                {
+                    for (auto i = bucketStart[bucket]; i < bucketStart[bucket + 1]; ++i)
+                    {
+                        const auto slot = hash_name(name_of(members[i]), seed) & mask;
+                        used[slot] = true;
+                        this->entries[slot] = static_cast<std::uint32_t>(members[i] + 1);
+                    }
+                    this->seeds[bucket] = seed;
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * no name was given twice
+     */
+    constexpr bool isValid() const
+    {
+        return !this->duplicates;
+    }
+
+    constexpr PerfectHashView view() const
+    {
+        return PerfectHashView{this->seeds.data(), this->entries.data(), size - 1};
+    }
+
+private:
+    std::array<std::uint32_t, size> seeds{};
+    std::array<std::uint32_t, size> entries{};
+    bool duplicates = false;
+};
+
+/**
+ * Direct lookup table for single character short names,
+ * maps the character to the argument position + 1, zero for unused characters.
+ */
+using CharacterIndex = std::array<std::uint32_t, 256>;
+
+template<std::size_t N>
+constexpr CharacterIndex makeCharacterIndex(const std::array<ArgumentDefinition, N> &definitions)
+{
+    CharacterIndex index{};
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        if (definitions[i].shortName().size() == 1)
+        {
+            index[static_cast<unsigned char>(definitions[i].shortName()[0])] = static_cast<std::uint32_t>(i + 1);
+        }
+    }
+    return index;
+}
+
+/**
+ * Argument definitions which are known at compile time, see `makeStaticSchema()`.
+ */
+template<std::size_t N>
+struct StaticSchema final
+{
+public:
+    constexpr StaticSchema(const std::array<ArgumentDefinition, N> &definitions)
+        : definitions(definitions),
+          shortIndex(definitions, true),
+          longIndex(definitions, false),
+          characterIndex(makeCharacterIndex(definitions))
+    {
+    }
+
+    /**
+     * every definition has a name and no short or long name is used twice
+     */
+    constexpr bool isValid() const
+    {
+        for (auto &&definition : this->definitions)
+        {
+            if (!definition.isValid())
+            {
+                return false;
+            }
+        }
+        return this->shortIndex.isValid() && this->longIndex.isValid();
+    }
+
+    const std::array<ArgumentDefinition, N> definitions;
+    const PerfectHashTable<N> shortIndex;
+    const PerfectHashTable<N> longIndex;
+    const CharacterIndex characterIndex;
+};
+
+/**
+ * Creates a schema at compile time.
+ *
+ * ```cpp
+ * static constexpr auto options = argparse::makeStaticSchema(
+ *     argparse::ArgumentDefinition("h", "help", "Print this help and exit", argparse::Argument::Boolean),
+ *     argparse::ArgumentDefinition("o", "output", "Output file"));
+ *
+ * const auto schema = argparse::ArgumentSchema::fromStatic<options>();
+ * ```
+ */
+template<typename... Definitions>
+constexpr StaticSchema<sizeof...(Definitions)> makeStaticSchema(const Definitions&... definitions)
+{
+    return StaticSchema<sizeof...(Definitions)>(std::array<ArgumentDefinition, sizeof...(Definitions)>{definitions...});
+}
+
+} // namespace argparse
+
+#endif // LIBARGPARSE_STATIC_SCHEMA_HPP
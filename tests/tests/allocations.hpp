@@ -0,0 +1,90 @@
+#ifndef ARGPARSE_TESTS_ALLOCATIONS_HPP
+#define ARGPARSE_TESTS_ALLOCATIONS_HPP
+
+/**
+ * Counts heap allocations of the test executable by replacing the
+ * global allocation functions. Only include this header once.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace allocations
+{
+    inline std::atomic<std::size_t> &counter()
+    {
+        static std::atomic<std::size_t> count{0};
+        return count;
+    }
+
+    /**
+     * number of heap allocations done while running the given function
+     */
+    template<typename Function>
+    std::size_t count(Function &&func)
+    {
+        const auto before = counter().load();
+        func();
+        return counter().load() - before;
+    }
+}
+
+void *operator new(std::size_t size)
+{
+    ++allocations::counter();
+    if (void *ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+// used by std::pmr::new_delete_resource()
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++allocations::counter();
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void *ptr = std::aligned_alloc(align, (size + align - 1) / align * align + (size ? 0 : align)))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+#endif // ARGPARSE_TESTS_ALLOCATIONS_HPP
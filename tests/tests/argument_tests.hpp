@@ -6,6 +6,26 @@ using namespace snowhouse;
 using namespace bandit;
 
 #include <argparse/argument.hpp>
+#include <argparse/schema.hpp>
+
+#include <clocale>
+
+namespace {
+
+enum class Color { Red, Green };
+
+} // anonymous namespace
+
+template<>
+struct argparse::converter<Color>
+{
+    static std::optional<Color> convert(std::string_view value)
+    {
+        if (value == "red") return Color::Red;
+        if (value == "green") return Color::Green;
+        return std::nullopt;
+    }
+};
 
 go_bandit([]{
     describe("Argument", []{
@@ -160,5 +180,191 @@ go_bandit([]{
             AssertThat(arg.get<bool>(&ok), Equals(false));
             AssertThat(ok, IsTrue());
         });
+
+        benchmark_it("[convertFloatingPoint]", [&]{
+            using namespace argparse;
+
+            bool ok = false;
+
+            Argument arg("", "", "");
+            const auto convert = [&](const char *value) {
+                arg.setValue(value);
+                return arg.get<double>(&ok);
+            };
+
+            AssertThat(convert("-0.25"), Equals(-0.25));
+            AssertThat(ok, IsTrue());
+            AssertThat(convert("1e3"), Equals(1000.0));
+            AssertThat(ok, IsTrue());
+            arg.setValue("1.5");
+            AssertThat(arg.get<float>(&ok), Equals(1.5f));
+            AssertThat(ok, IsTrue());
+            AssertThat(arg.get<long double>(&ok), Equals(1.5L));
+            AssertThat(ok, IsTrue());
+
+            // the whole value must be a number
+            AssertThat(convert("1.5abc"), Equals(0.0));
+            AssertThat(ok, IsFalse());
+            AssertThat(convert(" 1.5"), Equals(0.0));
+            AssertThat(ok, IsFalse());
+            AssertThat(convert("+1.5"), Equals(0.0));
+            AssertThat(ok, IsFalse());
+            AssertThat(convert("0x10"), Equals(0.0));
+            AssertThat(ok, IsFalse());
+            AssertThat(convert(""), Equals(0.0));
+            AssertThat(ok, IsFalse());
+            arg.setValue("1e100");
+            AssertThat(arg.get<float>(&ok), Equals(0.f));
+            AssertThat(ok, IsFalse());
+
+            // the decimal separator doesn't depend on the locale
+            if (std::setlocale(LC_NUMERIC, "de_DE.UTF-8"))
+            {
+                AssertThat(convert("1.5"), Equals(1.5));
+                AssertThat(ok, IsTrue());
+                AssertThat(convert("1,5"), Equals(0.0));
+                AssertThat(ok, IsFalse());
+                std::setlocale(LC_NUMERIC, "C");
+            }
+
+            arg.setValue("1234.5678");
+            double sum = 0;
+            for (auto i = 0u; i < 1000000; ++i)
+            {
+                sum += arg.get<double>(&ok);
+            }
+            AssertThat(sum, IsGreaterThan(1234567800.0 - 1));
+        });
+
+        // invalid numbers are reported without throwing and unwinding
+        benchmark_it("[convertFloatingPointErrors]", [&]{
+            using namespace argparse;
+
+            bool ok = false;
+
+            Argument arg("", "", "");
+            arg.setValue("not a number");
+
+            auto failures = 0u;
+            for (auto i = 0u; i < 1000000; ++i)
+            {
+                arg.get<double>(&ok);
+                failures += !ok;
+            }
+            AssertThat(failures, Equals(1000000u));
+        });
+
+        benchmark_it("[convertDurations]", [&]{
+            using namespace argparse;
+            using namespace std::chrono_literals;
+
+            using Seconds = converter<std::chrono::seconds>;
+            using Milliseconds = converter<std::chrono::milliseconds>;
+
+            AssertThat(Milliseconds::convert("250ms").value() == 250ms, IsTrue());
+            AssertThat(Milliseconds::convert("1h30m").value() == 90min, IsTrue());
+            AssertThat(Milliseconds::convert("2d").value() == 48h, IsTrue());
+            AssertThat(Milliseconds::convert("1s500ms").value() == 1500ms, IsTrue());
+            AssertThat(Milliseconds::convert("-5s").value() == -5s, IsTrue());
+            AssertThat(Milliseconds::convert("750").value() == 750ms, IsTrue()); // the period of the duration
+            AssertThat(Seconds::convert("90").value() == 90s, IsTrue());
+            AssertThat(Seconds::convert("1500ms").value() == 1s, IsTrue());
+            AssertThat(converter<std::chrono::duration<double>>::convert("1500ms").value().count(), Equals(1.5));
+            AssertThat(converter<std::chrono::nanoseconds>::convert("10us").value().count(), Equals(10000));
+
+            AssertThat(Seconds::convert("").has_value(), IsFalse());
+            AssertThat(Seconds::convert("s").has_value(), IsFalse());
+            AssertThat(Seconds::convert("5x").has_value(), IsFalse());
+            AssertThat(Seconds::convert("1h30").has_value(), IsFalse());
+            AssertThat(Seconds::convert("+5s").has_value(), IsFalse());
+            AssertThat(Seconds::convert("99999999999d").has_value(), IsFalse());
+        });
+
+        benchmark_it("[convertByteSizes]", [&]{
+            using namespace argparse;
+
+            const auto bytes = [](std::string_view value) {
+                const auto size = converter<ByteSize>::convert(value);
+                return size.has_value() ? static_cast<long long>(size->bytes()) : -1ll;
+            };
+
+            AssertThat(bytes("512"), Equals(512));
+            AssertThat(bytes("512B"), Equals(512));
+            AssertThat(bytes("64K"), Equals(65536));
+            AssertThat(bytes("64k"), Equals(65536));
+            AssertThat(bytes("64KB"), Equals(65536));
+            AssertThat(bytes("64KiB"), Equals(65536));
+            AssertThat(bytes("1.5G"), Equals(1610612736));
+            AssertThat(bytes("2T"), Equals(2199023255552));
+            AssertThat(bytes("0.5B"), Equals(0));
+
+            AssertThat(bytes(""), Equals(-1));
+            AssertThat(bytes("K"), Equals(-1));
+            AssertThat(bytes("-1K"), Equals(-1));
+            AssertThat(bytes("64X"), Equals(-1));
+            AssertThat(bytes("64Kb"), Equals(-1));
+            AssertThat(bytes("16E"), Equals(-1)); // 2^64
+        });
+
+        benchmark_it("[convertAddresses]", [&]{
+            using namespace argparse;
+
+            const auto address = [](std::string_view value) {
+                const auto converted = converter<IPAddress>::convert(value);
+                return converted.has_value() ? converted->toString() : std::string("invalid");
+            };
+
+            const auto localhost = converter<IPAddress>::convert("127.0.0.1");
+            AssertThat(localhost.has_value(), IsTrue());
+            AssertThat(localhost->family(), Equals(IPAddress::V4));
+            AssertThat(localhost->size(), Equals(4u));
+            AssertThat(localhost->bytes()[0], Equals(127));
+            AssertThat(localhost->bytes()[3], Equals(1));
+
+            AssertThat(address("192.168.0.255"), Equals("192.168.0.255"));
+            AssertThat(address("::1"), Equals("::1"));
+            AssertThat(address("2001:DB8:0:0:0:0:0:1"), Equals("2001:db8::1"));
+            AssertThat(address("::ffff:10.0.0.1"), Equals("::ffff:10.0.0.1"));
+            AssertThat(converter<IPAddress>::convert("::1")->family(), Equals(IPAddress::V6));
+
+            AssertThat(address(""), Equals("invalid"));
+            AssertThat(address("256.0.0.1"), Equals("invalid"));
+            AssertThat(address("1.2.3"), Equals("invalid"));
+            AssertThat(address("1.2.3.4.5"), Equals("invalid"));
+            AssertThat(address("01.2.3.4"), Equals("invalid"));
+            AssertThat(address("1.2.3.-4"), Equals("invalid"));
+            AssertThat(address("2001:db8::1::2"), Equals("invalid"));
+            AssertThat(address("::1%eth0"), Equals("invalid"));
+        });
+
+        benchmark_it("[convertCustomTypes]", [&]{
+            using namespace argparse;
+
+            ArgumentSchema schema;
+            schema.addArgument("", "color", "");
+            schema.addArgument("", "timeout", "");
+            schema.addArgument("", "cache", "");
+            schema.addArgument("", "config", "");
+            const std::vector<std::string> args{"app", "--color", "green", "--timeout", "30s", "--cache", "256M", "--config", "/etc/app.conf"};
+            const auto parsed = schema.parse(args);
+
+            bool ok = false;
+            AssertThat(parsed.get<Color>("color", &ok) == Color::Green, IsTrue());
+            AssertThat(ok, IsTrue());
+            AssertThat(parsed.get<std::chrono::seconds>("timeout").count(), Equals(30));
+            AssertThat(parsed.get<ByteSize>("cache").bytes(), Equals(256u << 20));
+            AssertThat(parsed.get<std::filesystem::path>("config").filename().string(), Equals("app.conf"));
+
+            parsed.get<std::chrono::seconds>("color", &ok);
+            AssertThat(ok, IsFalse());
+
+            // durations and byte sizes are cached after the first read
+            std::int64_t sum = 0;
+            for (auto i = 0u; i < 1000000; ++i)
+            {
+                sum += parsed.get<std::chrono::milliseconds>("timeout").count();
+            }
+            AssertThat(sum, Equals(30000ll * 1000000));
+        });
     });
 });
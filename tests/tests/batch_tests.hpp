@@ -0,0 +1,94 @@
+#include <bandit/bandit.h>
+
+#include "benchmark.hpp"
+
+using namespace snowhouse;
+using namespace bandit;
+
+#include <argparse/batch.hpp>
+
+#include <thread>
+
+go_bandit([]{
+    describe("Batch", []{
+        using namespace argparse;
+
+        const auto registerDefaultArguments = [](ArgumentSchema &schema) {
+            schema.addHelpOption("Print this help and quit");
+            schema.addArgument("v", "version", "Show application version", Argument::Boolean);
+            schema.addArgument("", "value", "");
+            schema.addArgument("", "required", "", Argument::String, true);
+        };
+
+        benchmark_it("[inputOrder]", [&]{
+            ArgumentSchema schema;
+            registerDefaultArguments(schema);
+
+            std::vector<std::vector<std::string>> commandLines;
+            for (auto i = 0u; i < 1000; ++i)
+            {
+                if (i % 3 == 0)
+                {
+                    commandLines.push_back({"app", "--value", std::to_string(i)});
+                }
+                else
+                {
+                    commandLines.push_back({"app", "--value", std::to_string(i), "--required", "x"});
+                }
+            }
+
+            const auto results = parseBatch(schema, commandLines, 4);
+
+            AssertThat(results.size(), Equals(commandLines.size()));
+            for (auto i = 0u; i < results.size(); ++i)
+            {
+                const auto expected = i % 3 == 0 ? ArgumentParserResult::MissingArgument : ArgumentParserResult::Success;
+                AssertThat(results[i].result(), Equals(expected));
+                if (expected == ArgumentParserResult::Success)
+                {
+                    AssertThat(results[i].get<unsigned>("value"), Equals(i));
+                }
+            }
+        });
+
+        benchmark_it("[emptyBatch]", [&]{
+            ArgumentSchema schema;
+            registerDefaultArguments(schema);
+
+            const auto results = parseBatch(schema, std::vector<std::vector<std::string>>{});
+            AssertThat(results.size(), Equals(0u));
+        });
+
+        // parsing 200k command lines should scale nearly linear with the thread count
+        std::vector<std::vector<std::string>> scalingInput;
+        for (auto i = 0u; i < 200000; ++i)
+        {
+            scalingInput.push_back({"app", "--value", std::to_string(i), "-v", "lose", "--required", "x", "--unknown"});
+        }
+
+        const auto scaling = [&](unsigned threads) {
+            ArgumentSchema schema;
+            registerDefaultArguments(schema);
+
+            const auto results = parseBatch(schema, scalingInput, threads);
+            AssertThat(results.size(), Equals(scalingInput.size()));
+            AssertThat(results.back().result(), Equals(ArgumentParserResult::Success));
+        };
+
+        benchmark_it("[scaling1]", [&]{
+            scaling(1);
+        });
+
+        benchmark_it("[scaling2]", [&]{
+            scaling(2);
+        });
+
+        benchmark_it("[scaling4]", [&]{
+            scaling(4);
+        });
+
+        benchmark_it("[scalingN]", [&]{
+            scaling(std::thread::hardware_concurrency());
+        });
+    });
+});
@@ -0,0 +1,327 @@
+#include <bandit/bandit.h>
+
+#include "benchmark.hpp"
+#include "environment.hpp"
+#include "allocations.hpp"
+
+using namespace snowhouse;
+using namespace bandit;
+
+#include <argparse/argparse.hpp>
+#ifdef LIBARGPARSE_HAS_CONFIG_WATCHER
+#include <argparse/config_watcher.hpp>
+#endif
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+go_bandit([]{
+    describe("ConfigFiles", []{
+        using namespace argparse;
+
+        // writes a config file into the temporary directory and returns its path
+        const auto writeFile = [](const std::string &name, const std::string &content) {
+            const auto path = std::filesystem::temp_directory_path() / ("argparse-tests-config-" + name);
+            std::ofstream(path, std::ios::binary) << content;
+            return path.string();
+        };
+
+        benchmark_it("[keyValue]", [&]{
+            const auto file = writeFile("keyValue",
+                "# comment line\n"
+                "; another comment\n"
+                "[section]\n"
+                "  output = a.out  \n"
+                "name=\"quoted value\"\n"
+                "empty =\n"
+                "color = true\n"
+                "quiet = 0\n"
+                "unknown = ignored\n"
+                "\r\n"
+                "jobs = 4\r\n"
+                "jobs = 8");
+
+            ArgumentParser parser({"app"});
+            parser.setConfigFile(file);
+            parser.addArgument("j", "jobs", "");
+            parser.addArgument("", "output", "");
+            parser.addArgument("", "name", "");
+            parser.addArgument("", "empty", "");
+            parser.addArgument("", "color", "", Argument::Boolean);
+            parser.addArgument("", "quiet", "", Argument::Boolean);
+            const auto res = parser.parse();
+
+            AssertThat(res, Equals(ArgumentParserResult::Success));
+            AssertThat(parser.get<int>("jobs"), Equals(8));
+            AssertThat(parser.get("output"), Equals("a.out"));
+            AssertThat(parser.get("name"), Equals("quoted value"));
+            AssertThat(parser.exists("empty"), IsTrue());
+            AssertThat(parser.get("empty"), Equals(""));
+            AssertThat(parser.exists("color"), IsTrue());
+            AssertThat(parser.exists("quiet"), IsFalse());
+        });
+
+        benchmark_it("[precedence]", [&]{
+            const auto file = writeFile("precedence",
+                "jobs = 4\n"
+                "output = config.out\n"
+                "token = from-config\n"
+                "define = a\n"
+                "define = b\n"
+                "include = config\n");
+
+            ArgumentSchema schema;
+            schema.addArgument("j", "jobs", "", "1");
+            schema.addArgument("", "output", "");
+            schema.addArgument("", "token", "", Argument::String, true);
+            schema.addArgument("", "define", "", Argument::Append);
+            schema.addArgument("", "include", "", Argument::Append);
+            schema.addArgument("", "cache", "", "default");
+            schema.setEnvironmentVariable("output", "ARGPARSE_TEST_CONFIG_OUTPUT");
+            environment::set("ARGPARSE_TEST_CONFIG_OUTPUT", "env.out");
+
+            // command line > environment > config file > default value
+            const std::vector<std::string> args{"app", "--jobs", "2", "--include", "cli"};
+            const auto parsed = schema.parse(args, file);
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed.get<int>("jobs"), Equals(2));
+            AssertThat(parsed.get("output"), Equals("env.out"));
+            AssertThat(parsed.get("token"), Equals("from-config"));
+            const auto defines = parsed.getAll("define");
+            AssertThat(std::vector<std::string_view>(defines.begin(), defines.end()),
+                Equals(std::vector<std::string_view>{"a", "b"}));
+            const auto includes = parsed.getAll("include");
+            AssertThat(std::vector<std::string_view>(includes.begin(), includes.end()),
+                Equals(std::vector<std::string_view>{"cli"}));
+            AssertThat(parsed.exists("cache"), IsFalse());
+
+            // required arguments are missing without the config file
+            AssertThat(schema.parse(args).result(), Equals(ArgumentParserResult::MissingArgument));
+
+            environment::unset("ARGPARSE_TEST_CONFIG_OUTPUT");
+        });
+
+        benchmark_it("[errors]", [&]{
+            ArgumentSchema schema;
+            schema.addArgument("", "value", "");
+
+            const std::vector<std::string> args{"app"};
+            const auto missing = (std::filesystem::temp_directory_path() / "argparse-tests-config-missing").string();
+            AssertThat(schema.parse(args, missing).result(), Equals(ArgumentParserResult::ConfigFileError));
+            AssertThat(schema.parse(args, writeFile("malformed", "value = 1\nno separator\n")).result(),
+                Equals(ArgumentParserResult::ConfigFileError));
+            AssertThat(schema.parse(args, writeFile("empty", "")).result(), Equals(ArgumentParserResult::Success));
+        });
+
+        // the values are views into the mapped file, reading it doesn't allocate per line
+        benchmark_it("[100kLines]", [&]{
+            ArgumentSchema schema;
+            schema.reserve(1000);
+            for (auto i = 0u; i < 1000; ++i)
+            {
+                schema.addArgument("", "option-" + std::to_string(i), "");
+            }
+
+            std::string content;
+            for (auto i = 0u; i < 100000; ++i)
+            {
+                content += "option-" + std::to_string(i % 1000) + " = some value of line " + std::to_string(i) + "\n";
+            }
+            const auto file = writeFile("lines", content);
+
+            const std::vector<std::string> args{"app"};
+            ParsedArguments parsed;
+            const auto count = allocations::count([&]{ parsed = schema.parse(args, file); });
+
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed.get("option-999"), Equals("some value of line 99999"));
+            AssertThat(count, IsLessThan(64));
+        });
+
+#ifdef LIBARGPARSE_HAS_CONFIG_WATCHER
+        benchmark_it("[reload]", [&]{
+            const auto file = writeFile("reload", "jobs = 1\noutput = a.out\n");
+
+            ArgumentSchema schema;
+            schema.addArgument("j", "jobs", "");
+            schema.addArgument("", "output", "");
+            schema.addArgument("", "define", "", Argument::Append);
+            const std::vector<std::string> args{"app"};
+
+            std::vector<std::string> changed;
+            ConfigWatcher watcher(schema, CommandLine(args), file, [&](const auto &names, const auto &current) {
+                AssertThat(current->result(), Equals(ArgumentParserResult::Success));
+                changed.assign(names.begin(), names.end());
+            });
+            AssertThat(watcher.current()->get<int>("jobs"), Equals(1));
+
+            // the same content doesn't parse again
+            writeFile("reload", "jobs = 1\noutput = a.out\n");
+            AssertThat(watcher.reload(), IsFalse());
+
+            // only the changed arguments are reported
+            const auto previous = watcher.current();
+            writeFile("reload", "jobs = 2\noutput = a.out\ndefine = x\n");
+            AssertThat(watcher.reload(), IsTrue());
+            AssertThat(changed, Equals(std::vector<std::string>{"jobs", "define"}));
+            AssertThat(watcher.current()->get<int>("jobs"), Equals(2));
+            AssertThat(previous->get<int>("jobs"), Equals(1)); // old snapshots stay valid
+
+            // broken files keep the current result
+            writeFile("reload", "jobs 3\n");
+            AssertThat(watcher.reload(), IsFalse());
+            AssertThat(watcher.current()->get<int>("jobs"), Equals(2));
+        });
+
+        // the handler runs without the reload lock
+        benchmark_it("[reloadFromHandler]", [&]{
+            const auto file = writeFile("reentrant", "jobs = 1\n");
+
+            ArgumentSchema schema;
+            schema.addArgument("j", "jobs", "");
+            const std::vector<std::string> args{"app"};
+
+            auto calls = 0u;
+            ConfigWatcher *self = nullptr;
+            ConfigWatcher watcher(schema, CommandLine(args), file, [&](const auto &, const auto &current) {
+                ++calls;
+                AssertThat(self->current()->get<int>("jobs"), Equals(current->template get<int>("jobs")));
+                AssertThat(self->reload(), IsFalse()); // unchanged content
+            });
+            self = &watcher;
+
+            writeFile("reentrant", "jobs = 2\n");
+            AssertThat(watcher.reload(), IsTrue());
+            AssertThat(calls, Equals(1u));
+        });
+
+        benchmark_it("[stopFromHandler]", [&]{
+            const auto file = writeFile("stop", "jobs = 1\n");
+
+            ArgumentSchema schema;
+            schema.addArgument("j", "jobs", "");
+            const std::vector<std::string> args{"app"};
+
+            std::mutex mutex;
+            std::condition_variable condition;
+            bool stopped = false;
+
+            ConfigWatcher *self = nullptr;
+            ConfigWatcher watcher(schema, CommandLine(args), file, [&](const auto &, const auto &) {
+                self->stop();
+                std::lock_guard<std::mutex> lock(mutex);
+                stopped = !self->running();
+                condition.notify_all();
+            });
+            self = &watcher;
+            AssertThat(watcher.start(), IsTrue());
+
+            writeFile("stop", "jobs = 2\n");
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait_for(lock, std::chrono::seconds(5), [&]{ return stopped; });
+                AssertThat(stopped, IsTrue());
+            }
+
+            AssertThat(watcher.running(), IsFalse());
+            AssertThat(watcher.start(), IsTrue());
+            AssertThat(watcher.running(), IsTrue());
+        });
+
+        // readers take no lock while results are replaced and retired,
+        // build with ARGPARSE_TESTS_TSAN=ON to let ThreadSanitizer verify this test
+        benchmark_it("[concurrentReaders]", [&]{
+            const auto file = writeFile("readers", "jobs = 0\n");
+
+            ArgumentSchema schema;
+            schema.addArgument("j", "jobs", "");
+            const std::vector<std::string> args{"app"};
+            ConfigWatcher watcher(schema, CommandLine(args), file);
+
+            std::atomic<bool> done{false};
+            std::atomic<unsigned> failures{0};
+            std::vector<std::thread> readers;
+            for (auto t = 0u; t < 4; ++t)
+            {
+                readers.emplace_back([&]{
+                    int last = 0;
+                    while (!done)
+                    {
+                        const auto jobs = watcher.current()->get<int>("jobs");
+                        failures += jobs < last; // results are published in order
+                        last = jobs;
+                    }
+                });
+            }
+
+            for (auto i = 1; i <= 200; ++i)
+            {
+                writeFile("readers", "jobs = " + std::to_string(i) + "\n");
+                watcher.reload();
+            }
+
+            done = true;
+            for (auto &reader : readers)
+            {
+                reader.join();
+            }
+            AssertThat(failures.load(), Equals(0u));
+            AssertThat(watcher.current()->get<int>("jobs"), Equals(200));
+        });
+
+        benchmark_it("[watch]", [&]{
+            const auto file = writeFile("watch", "jobs = 1\n");
+
+            ArgumentSchema schema;
+            schema.addArgument("j", "jobs", "");
+            schema.addArgument("", "output", "");
+            const std::vector<std::string> args{"app", "--output", "a.out"};
+
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::vector<std::string> changed;
+
+            ConfigWatcher watcher(schema, CommandLine(args), file, [&](const auto &names, const auto &) {
+                std::lock_guard<std::mutex> lock(mutex);
+                changed.assign(names.begin(), names.end());
+                condition.notify_all();
+            });
+            AssertThat(watcher.start(), IsTrue());
+            AssertThat(watcher.running(), IsTrue());
+
+            // readers never block while the watcher swaps the result
+            std::atomic<bool> done{false};
+            std::thread reader([&]{
+                while (!done)
+                {
+                    const auto current = watcher.current();
+                    const auto jobs = current->get<int>("jobs");
+                    AssertThat(jobs == 1 || jobs == 2, IsTrue());
+                }
+            });
+
+            writeFile("watch", "jobs = 2\noutput = ignored\n");
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait_for(lock, std::chrono::seconds(5), [&]{ return !changed.empty(); });
+                AssertThat(changed, Equals(std::vector<std::string>{"jobs"}));
+            }
+
+            done = true;
+            reader.join();
+            watcher.stop();
+            AssertThat(watcher.running(), IsFalse());
+            AssertThat(watcher.current()->get<int>("jobs"), Equals(2));
+            AssertThat(watcher.current()->get("output"), Equals("a.out"));
+        });
+#endif
+    });
+});
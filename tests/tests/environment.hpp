@@ -0,0 +1,33 @@
+#ifndef ARGPARSE_TESTS_ENVIRONMENT_HPP
+#define ARGPARSE_TESTS_ENVIRONMENT_HPP
+
+/**
+ * Sets and removes environment variables on POSIX systems and Windows.
+ */
+
+#include <argparse/internal/platform.hpp>
+
+#include <cstdlib>
+
+namespace environment
+{
+    inline void set(const char *name, const char *value)
+    {
+#if LIBARGPARSE_POSIX
+        ::setenv(name, value, 1);
+#else
+        ::_putenv_s(name, value);
+#endif
+    }
+
+    inline void unset(const char *name)
+    {
+#if LIBARGPARSE_POSIX
+        ::unsetenv(name);
+#else
+        ::_putenv_s(name, ""); // an empty value removes the variable
+#endif
+    }
+}
+
+#endif // ARGPARSE_TESTS_ENVIRONMENT_HPP
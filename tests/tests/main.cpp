@@ -3,8 +3,14 @@
 #include "benchmark.hpp"
 
 #include "argument_tests.hpp"
+#include "batch_tests.hpp"
+#include "config_file_tests.hpp"
 #include "parser_tests.hpp"
 #include "printer_tests.hpp"
+#include "response_file_tests.hpp"
+#include "schema_tests.hpp"
+#include "static_schema_tests.hpp"
+#include "stream_tests.hpp"
 
 bool check_has_info_reporter(int argc, char **argv)
 {
@@ -1,12 +1,16 @@
 #include <bandit/bandit.h>
 
 #include "benchmark.hpp"
+#include "allocations.hpp"
 
 using namespace snowhouse;
 using namespace bandit;
 
 #include <argparse/argparse.hpp>
 
+#include <thread>
+#include <atomic>
+
 go_bandit([]{
     describe("Parser", []{
         using namespace argparse;
@@ -54,9 +58,9 @@ go_bandit([]{
 
             AssertThat(res, Equals(ArgumentParserResult::MissingArgument));
             AssertThat(parser.exists("required"), IsFalse());
-            AssertThat(parser.missingArguments(), Equals(std::list<std::string>{"required"}));
+            AssertThat(parser.missingArguments(), Equals(StringList{"required"}));
 
-            AssertThat(parser.loseArguments(), Equals(std::list<std::string>{}));
+            AssertThat(parser.loseArguments(), Equals(StringList{}));
         });
 
         benchmark_it("[requiredArgumentDefault]", [&]{
@@ -67,10 +71,10 @@ go_bandit([]{
 
             AssertThat(res, Equals(ArgumentParserResult::Success));
             AssertThat(parser.exists("required"), IsTrue());
-            AssertThat(parser.missingArguments(), Equals(std::list<std::string>{}));
+            AssertThat(parser.missingArguments(), Equals(StringList{}));
             AssertThat(parser.get("required"), Equals("default"));
 
-            AssertThat(parser.loseArguments(), Equals(std::list<std::string>{}));
+            AssertThat(parser.loseArguments(), Equals(StringList{}));
 
 
             ArgumentParser parser2({"app", "--required", "another_value"});
@@ -80,10 +84,10 @@ go_bandit([]{
 
             AssertThat(res2, Equals(ArgumentParserResult::Success));
             AssertThat(parser2.exists("required"), IsTrue());
-            AssertThat(parser2.missingArguments(), Equals(std::list<std::string>{}));
+            AssertThat(parser2.missingArguments(), Equals(StringList{}));
             AssertThat(parser2.get("required"), Equals("another_value"));
 
-            AssertThat(parser2.loseArguments(), Equals(std::list<std::string>{}));
+            AssertThat(parser2.loseArguments(), Equals(StringList{}));
         });
 
         benchmark_it("[booleanSwitch]", [&]{
@@ -96,7 +100,7 @@ go_bandit([]{
             AssertThat(parser.exists("enabled"), IsTrue());
             AssertThat(parser.get("enabled"), Equals("true")); // boolean switches don't have values
 
-            AssertThat(parser.loseArguments(), Equals(std::list<std::string>{"value", "abc"}));
+            AssertThat(parser.loseArguments(), Equals(StringList{"value", "abc"}));
         });
 
         benchmark_it("[valueSwitch]", [&]{
@@ -113,7 +117,7 @@ go_bandit([]{
             AssertThat(parser.get("value"), Equals("abc"));
             AssertThat(parser.get("nonexistend"), Equals(""));
 
-            AssertThat(parser.loseArguments(), Equals(std::list<std::string>{}));
+            AssertThat(parser.loseArguments(), Equals(StringList{}));
         });
 
         benchmark_it("[multipleValues]", [&]{
@@ -129,7 +133,7 @@ go_bandit([]{
             AssertThat(parser.get("value"), Equals("abc"));
             AssertThat(parser.get("value2"), Equals("xyz"));
 
-            AssertThat(parser.loseArguments(), Equals(std::list<std::string>{"def"}));
+            AssertThat(parser.loseArguments(), Equals(StringList{"def"}));
         });
 
         benchmark_it("[castingTestSuccess]", [&]{
@@ -148,7 +152,7 @@ go_bandit([]{
             value = parser.get<int>("value");
             AssertThat(value, Equals(10));
 
-            AssertThat(parser.loseArguments(), Equals(std::list<std::string>{}));
+            AssertThat(parser.loseArguments(), Equals(StringList{}));
         });
 
         benchmark_it("[castingTestFailure]", [&]{
@@ -171,7 +175,7 @@ go_bandit([]{
             AssertThat(ok, IsTrue());
             AssertThat(value2, IsGreaterThanOrEqualTo(3.1f)); // don't do exact comparisson due to floating point madness
 
-            AssertThat(parser.loseArguments(), Equals(std::list<std::string>{}));
+            AssertThat(parser.loseArguments(), Equals(StringList{}));
         });
 
         benchmark_it("[unicode]", [&]{
@@ -188,7 +192,7 @@ go_bandit([]{
             AssertThat(parser.get("コマンド"), Equals("表示"));
             AssertThat(parser.get("コ"), Equals("表示"));
 
-            AssertThat(parser.loseArguments(), Equals(std::list<std::string>{}));
+            AssertThat(parser.loseArguments(), Equals(StringList{}));
         });
 
         benchmark_it("[loseArguments]", [&]{
@@ -205,7 +209,7 @@ go_bandit([]{
             AssertThat(parser.get("value2"), Equals("xyz"));
             AssertThat(parser.exists("unused"), IsFalse());
 
-            AssertThat(parser.loseArguments(), Equals(std::list<std::string>{"def", "lose1", "lose2", "lose3"}));
+            AssertThat(parser.loseArguments(), Equals(StringList{"def", "lose1", "lose2", "lose3"}));
         });
 
         benchmark_it("[termination]", [&]{
@@ -223,8 +227,8 @@ go_bandit([]{
             AssertThat(parser.get("value2"), Equals(""));
             AssertThat(parser.exists("unused"), IsFalse());
 
-            AssertThat(parser.loseArguments(), Equals(std::list<std::string>{}));
-            AssertThat(parser.remainingArguments(), Equals(std::list<std::string>{"def", "--value2", "xyz", "lose1", "lose2", "--unused", "lose3"}));
+            AssertThat(parser.loseArguments(), Equals(StringList{}));
+            AssertThat(parser.remainingArguments(), Equals(StringList{"def", "--value2", "xyz", "lose1", "lose2", "--unused", "lose3"}));
         });
 
         benchmark_it("[termination2]", [&]{
@@ -235,8 +239,8 @@ go_bandit([]{
 
             AssertThat(res, Equals(ArgumentParserResult::Success));
 
-            AssertThat(parser.loseArguments(), Equals(std::list<std::string>{"abc"}));
-            AssertThat(parser.remainingArguments(), Equals(std::list<std::string>{}));
+            AssertThat(parser.loseArguments(), Equals(StringList{"abc"}));
+            AssertThat(parser.remainingArguments(), Equals(StringList{}));
         });
 
         benchmark_it("[emptyStringArgument]", [&]{
@@ -248,7 +252,501 @@ go_bandit([]{
             AssertThat(parser.exists("option"), IsTrue());
             AssertThat(parser.get("option"), Equals(""));
 
-            AssertThat(parser.loseArguments(), Equals(std::list<std::string>{}));
+            AssertThat(parser.loseArguments(), Equals(StringList{}));
+        });
+
+        benchmark_it("[shortOptionBundling]", [&]{
+            ArgumentParser parser({"app", "-abc", "-vofile", "-xa", "-i", "lose"});
+            parser.addArgument("a", "", "", Argument::Boolean);
+            parser.addArgument("b", "", "", Argument::Boolean);
+            parser.addArgument("c", "", "", Argument::Boolean);
+            parser.addArgument("v", "verbose", "", Argument::Boolean);
+            parser.addArgument("o", "output", "");
+            parser.addArgument("i", "input", "");
+            parser.addArgument("xa", "", "", Argument::Boolean);
+            const auto res = parser.parse();
+
+            AssertThat(res, Equals(ArgumentParserResult::Success));
+            AssertThat(parser.exists("a"), IsTrue());
+            AssertThat(parser.exists("b"), IsTrue());
+            AssertThat(parser.exists("c"), IsTrue());
+            AssertThat(parser.exists("verbose"), IsTrue());
+            AssertThat(parser.get("output"), Equals("file"));
+            AssertThat(parser.exists("xa"), IsTrue()); // registered names win over bundles
+            AssertThat(parser.get("input"), Equals("lose"));
+
+            ArgumentParser parser2({"app", "-abz", "-bo", "value"});
+            parser2.addArgument("a", "", "", Argument::Boolean);
+            parser2.addArgument("b", "", "", Argument::Boolean);
+            parser2.addArgument("o", "output", "");
+            const auto res2 = parser2.parse();
+
+            AssertThat(res2, Equals(ArgumentParserResult::Success));
+            AssertThat(parser2.exists("a"), IsFalse()); // unknown characters drop the whole bundle
+            AssertThat(parser2.exists("b"), IsTrue());
+            AssertThat(parser2.get("output"), Equals("value"));
+            AssertThat(parser2.loseArguments(), Equals(StringList{}));
+        });
+
+        benchmark_it("[joinedValues]", [&]{
+            ArgumentParser parser({"app", "--output=/tmp/x", "--define=-x", "--empty=", "-j=4", "-vi=a=b", "--verbose=1", "--unknown=abc"});
+            parser.addArgument("o", "output", "");
+            parser.addArgument("d", "define", "");
+            parser.addArgument("", "empty", "", "default", Argument::String, false);
+            parser.addArgument("j", "jobs", "");
+            parser.addArgument("i", "input", "");
+            parser.addArgument("v", "verbose", "", Argument::Boolean);
+            const auto res = parser.parse();
+
+            AssertThat(res, Equals(ArgumentParserResult::Success));
+            AssertThat(parser.get("output"), Equals("/tmp/x"));
+            AssertThat(parser.get("define"), Equals("-x")); // values starting with the prefix
+            AssertThat(parser.exists("empty"), IsTrue());
+            AssertThat(parser.get("empty"), Equals(""));
+            AssertThat(parser.get<int>("jobs"), Equals(4));
+            AssertThat(parser.get("input"), Equals("a=b"));
+            AssertThat(parser.get("verbose"), Equals("true"));
+
+            AssertThat(parser.loseArguments(), Equals(StringList{}));
+        });
+
+        // attached values of switches are read like the environment and config files
+        benchmark_it("[joinedSwitchValues]", [&]{
+            ArgumentParser parser({"app", "--color=false", "--quiet=0", "--empty=", "--verbose=yes", "-d", "--debug=false"});
+            parser.addArgument("", "color", "", Argument::Boolean);
+            parser.addArgument("", "quiet", "", Argument::Boolean);
+            parser.addArgument("", "empty", "", Argument::Boolean);
+            parser.addArgument("", "verbose", "", Argument::Boolean);
+            parser.addArgument("d", "debug", "", Argument::Boolean);
+            AssertThat(parser.parse(), Equals(ArgumentParserResult::Success));
+
+            AssertThat(parser.exists("color"), IsFalse());
+            AssertThat(parser.exists("quiet"), IsFalse());
+            AssertThat(parser.exists("empty"), IsFalse());
+            AssertThat(parser.exists("verbose"), IsTrue());
+            AssertThat(parser.exists("debug"), IsFalse()); // the last occurrence wins
+            AssertThat(parser.loseArguments(), Equals(StringList{}));
+        });
+
+        benchmark_it("[borrowedCommandLine]", [&]{
+            const char *argv[] = {"app", "--value", "abc", "-v", "lose"};
+            ArgumentParser parser(CommandLine(5, argv));
+            registerDefaultArguments(parser);
+            parser.addArgument("", "value", "");
+            const auto res = parser.parse();
+
+            AssertThat(res, Equals(ArgumentParserResult::Success));
+            AssertThat(parser.exists("version"), IsTrue());
+            AssertThat(parser.get("value"), Equals("abc"));
+
+            AssertThat(parser.loseArguments(), Equals(StringList{"lose"}));
+        });
+
+        benchmark_it("[appendValues]", [&]{
+            ArgumentParser parser({"app", "--include", "a", "-I", "b", "--jobs", "1", "-vIc", "--include=d", "--level", "2", "-L3", "--level", "x"});
+            parser.addArgument("I", "include", "", Argument::Append);
+            parser.addArgument("L", "level", "", Argument::Append);
+            parser.addArgument("", "define", "", Argument::Append);
+            parser.addArgument("", "jobs", "");
+            parser.addArgument("v", "verbose", "", Argument::Boolean);
+            const auto res = parser.parse();
+
+            AssertThat(res, Equals(ArgumentParserResult::Success));
+            const auto includes = parser.getAll("include");
+            AssertThat(std::vector<std::string_view>(includes.begin(), includes.end()),
+                Equals(std::vector<std::string_view>{"a", "b", "c", "d"}));
+            AssertThat(parser.get("include"), Equals("d")); // the last value
+            AssertThat(parser.getAll("define").size(), Equals(0u));
+            AssertThat(parser.get<int>("jobs"), Equals(1));
+            AssertThat(parser.exists("verbose"), IsTrue());
+
+            bool ok = false;
+            AssertThat(parser.getAll<int>("level", &ok), Equals(std::vector<int>{2, 3, 0}));
+            AssertThat(ok, IsFalse());
+
+            AssertThat(parser.loseArguments(), Equals(StringList{}));
+        });
+
+        // the values of repeated options are views into the command line,
+        // collecting them allocates once for all values
+        benchmark_it("[appendValuesScaling]", [&]{
+            std::vector<std::string> args{"app"};
+            for (auto i = 0u; i < 10000; ++i)
+            {
+                args.emplace_back("--define");
+                args.emplace_back("a long definition which doesn't fit into the small string buffer=" + std::to_string(i));
+            }
+
+            ArgumentParser parser(CommandLine{args});
+            parser.addArgument("D", "define", "", Argument::Append);
+
+            ArgumentParserResult res;
+            const auto count = allocations::count([&]{
+                res = parser.parse();
+            });
+
+            AssertThat(res, Equals(ArgumentParserResult::Success));
+            AssertThat(count, IsLessThan(40u));
+            const auto defines = parser.getAll("define");
+            AssertThat(defines.size(), Equals(10000u));
+            AssertThat(defines[9999], Equals(std::string_view(args.back())));
+        });
+
+        benchmark_it("[positionals]", [&]{
+            ArgumentParser parser({"app", "a.txt", "-v", "b.txt", "c.txt", "/tmp", "--", "d.txt"});
+            parser.addArgument("v", "verbose", "", Argument::Boolean);
+            parser.addPositional("source", "", Positional::AtLeastOne);
+            parser.addPositional("destination", "");
+            parser.addPositional("mode", "", Positional::Optional);
+            AssertThat(parser.addPositional("", ""), IsFalse());
+            AssertThat(parser.addPositional("source", ""), IsFalse());
+            parser.setTerminator();
+            const auto res = parser.parse();
+
+            AssertThat(res, Equals(ArgumentParserResult::Success));
+            const auto sources = parser.positionals("source");
+            AssertThat(std::vector<std::string_view>(sources.begin(), sources.end()),
+                Equals(std::vector<std::string_view>{"a.txt", "b.txt", "c.txt"}));
+            AssertThat(parser.positional("destination"), Equals("/tmp"));
+            AssertThat(parser.positionals("mode").size(), Equals(0u));
+
+            bool ok = true;
+            AssertThat(parser.positional("mode", 0, &ok), Equals(""));
+            AssertThat(ok, IsFalse());
+            AssertThat(parser.positional("source", 3, &ok), Equals(""));
+            AssertThat(ok, IsFalse());
+
+            AssertThat(parser.exists("verbose"), IsTrue());
+            AssertThat(parser.loseArguments(), Equals(StringList{}));
+            AssertThat(parser.remainingArguments(), Equals(StringList{"d.txt"}));
+
+            // optional positionals are filled before the remaining values become lose arguments
+            ArgumentParser parser2({"app", "1", "2", "3"});
+            parser2.addPositional("count", "");
+            parser2.addPositional("limit", "", Positional::Optional);
+            AssertThat(parser2.parse(), Equals(ArgumentParserResult::Success));
+            AssertThat(parser2.positional<int>("count"), Equals(1));
+            AssertThat(parser2.positional<int>("limit"), Equals(2));
+            AssertThat(parser2.loseArguments(), Equals(StringList{"3"}));
+
+            // positionals without values are missing
+            ArgumentParser parser3({"app", "a.txt"});
+            parser3.addPositional("source", "", Positional::AtLeastOne);
+            parser3.addPositional("destination", "");
+            AssertThat(parser3.parse(), Equals(ArgumentParserResult::MissingArgument));
+            AssertThat(parser3.missingArguments(), Equals(StringList{"destination"}));
+
+            ArgumentParser parser4({"app"});
+            parser4.addPositional("files", "", Positional::Any);
+            AssertThat(parser4.parse(), Equals(ArgumentParserResult::Success));
+            AssertThat(parser4.positionals("files").size(), Equals(0u));
+
+            ArgumentParser parser5({"app"});
+            parser5.addPositional("file", "");
+            AssertThat(parser5.parse(), Equals(ArgumentParserResult::InsufficientArguments));
+        });
+
+        // positional values are assigned once and converted once, indexed access is constant time
+        benchmark_it("[positionalsScaling]", [&]{
+            std::vector<std::string> args{"app"};
+            for (auto i = 0u; i < 100000; ++i)
+            {
+                args.emplace_back(std::to_string(i));
+            }
+
+            ArgumentParser parser(CommandLine{args});
+            parser.addPositional("numbers", "", Positional::AtLeastOne);
+            AssertThat(parser.parse(), Equals(ArgumentParserResult::Success));
+
+            std::uint64_t sum = 0;
+            for (auto pass = 0u; pass < 10; ++pass)
+            {
+                for (auto i = 0u; i < 100000; ++i)
+                {
+                    sum += parser.positional<unsigned>("numbers", i);
+                }
+            }
+            AssertThat(sum, Equals(10ull * 99999 * 100000 / 2));
+        });
+
+        benchmark_it("[handles]", [&]{
+            ArgumentParser parser({"app", "-j", "4", "--output", "a.out", "-v"});
+            const auto jobs = parser.addTypedArgument<int>("j", "jobs", "");
+            const auto output = parser.addTypedArgument("", "output", "");
+            const auto verbose = parser.addTypedArgument<bool>("v", "verbose", "", Argument::Boolean);
+            const auto level = parser.addTypedArgument<double>("", "level", "", "0.5", Argument::String, true);
+            const auto missing = parser.addTypedArgument<int>("", "missing", "");
+            const auto duplicate = parser.addTypedArgument<int>("j", "other", "");
+            AssertThat(jobs.isValid(), IsTrue());
+            AssertThat(duplicate.isValid(), IsFalse());
+            AssertThat(parser.handle<int>("jobs").position(), Equals(jobs.position()));
+            AssertThat(parser.handle("unknown").isValid(), IsFalse());
+            AssertThat(parser.parse(), Equals(ArgumentParserResult::Success));
+
+            bool ok = false;
+            AssertThat(parser.get(jobs, &ok), Equals(4));
+            AssertThat(ok, IsTrue());
+            AssertThat(parser.get(output), Equals("a.out"));
+            AssertThat(parser.get(verbose), IsTrue());
+            AssertThat(parser.get(level), Equals(0.5)); // the default value
+            AssertThat(parser.exists(missing), IsFalse());
+            AssertThat(parser.get(missing, &ok), Equals(0));
+            AssertThat(ok, IsFalse());
+            AssertThat(parser.get(duplicate, &ok), Equals(0));
+            AssertThat(ok, IsFalse());
+        });
+
+        // a request loop which reads 40 options per request
+        benchmark_it("[handles40]", [&]{
+            std::vector<std::string> args{"app"};
+            for (auto i = 0u; i < 40; ++i)
+            {
+                args.emplace_back("--option-" + std::to_string(i));
+                args.emplace_back(std::to_string(i));
+            }
+
+            ArgumentParser parser(CommandLine{args});
+            std::vector<ArgumentHandle<int>> handles;
+            for (auto i = 0u; i < 40; ++i)
+            {
+                handles.emplace_back(parser.addTypedArgument<int>("", "option-" + std::to_string(i), ""));
+            }
+            AssertThat(parser.parse(), Equals(ArgumentParserResult::Success));
+
+            std::uint64_t sum = 0;
+            for (auto request = 0u; request < 100000; ++request)
+            {
+                for (auto &&handle : handles)
+                {
+                    sum += static_cast<unsigned>(parser.get(handle));
+                }
+            }
+            AssertThat(sum, Equals(100000ull * 39 * 40 / 2));
+        });
+
+        benchmark_it("[bindings]", [&]{
+            struct Config
+            {
+                int threads = 1;
+                double ratio = 0.0;
+                std::string output = "default";
+                std::string_view name;
+                bool verbose = true;
+                std::vector<int> levels;
+                int untouched = 42;
+            } config;
+
+            ArgumentParser parser({"app", "-j", "8", "--ratio=0.25", "--output", "a.out", "--level", "1", "--level", "2", "--name", "x", "--bad", "abc"});
+            AssertThat(parser.bind(parser.addTypedArgument<int>("j", "threads", ""), &config.threads), IsTrue());
+            AssertThat(parser.bind(parser.addTypedArgument<double>("", "ratio", ""), &config.ratio), IsTrue());
+            parser.addArgument("", "output", "");
+            parser.addArgument("", "name", "");
+            parser.addArgument("v", "verbose", "", Argument::Boolean);
+            parser.addArgument("", "level", "", Argument::Append);
+            parser.addArgument("", "bad", "");
+            AssertThat(parser.bind("output", &config.output), IsTrue());
+            AssertThat(parser.bind("name", &config.name), IsTrue());
+            AssertThat(parser.bind("verbose", &config.verbose), IsTrue());
+            AssertThat(parser.bind("level", &config.levels), IsTrue());
+            AssertThat(parser.bind("bad", &config.untouched), IsTrue());
+            AssertThat(parser.bind("unknown", &config.untouched), IsFalse());
+            AssertThat(parser.parse(), Equals(ArgumentParserResult::Success));
+
+            AssertThat(config.threads, Equals(8));
+            AssertThat(config.ratio, Equals(0.25));
+            AssertThat(config.output, Equals("a.out"));
+            AssertThat(config.name, Equals("x"));
+            AssertThat(config.verbose, IsFalse());
+            AssertThat(config.levels, Equals(std::vector<int>{1, 2}));
+            AssertThat(config.untouched, Equals(42)); // conversion error
+
+            // the bound values are cached in the result
+            AssertThat(parser.get<int>("threads"), Equals(8));
+            AssertThat(parser.bind("output", &config.output), IsFalse());
+        });
+
+        // every option is passed once, with a hashed lookup the parsing time
+        // must grow linearly with the option count and not quadratically
+        const auto lookupScaling = [](std::size_t optionCount) {
+            std::vector<std::string> args{"app"};
+            args.reserve(optionCount * 2 + 1);
+            for (auto i = 0u; i < optionCount; ++i)
+            {
+                args.emplace_back("--option" + std::to_string(i));
+                args.emplace_back("value" + std::to_string(i));
+            }
+
+            ArgumentParser parser(args);
+            for (auto i = 0u; i < optionCount; ++i)
+            {
+                parser.addArgument("", "option" + std::to_string(i), "");
+            }
+            const auto res = parser.parse();
+
+            AssertThat(res, Equals(ArgumentParserResult::Success));
+            AssertThat(parser.get("option0"), Equals("value0"));
+            AssertThat(parser.get("option" + std::to_string(optionCount - 1)), Equals("value" + std::to_string(optionCount - 1)));
+            AssertThat(parser.loseArguments(), Equals(StringList{}));
+        };
+
+        benchmark_it("[lookupScaling10]", [&]{
+            lookupScaling(10);
+        });
+
+        benchmark_it("[lookupScaling100]", [&]{
+            lookupScaling(100);
+        });
+
+        benchmark_it("[lookupScaling1000]", [&]{
+            lookupScaling(1000);
+        });
+
+        benchmark_it("[lookupScaling10000]", [&]{
+            lookupScaling(10000);
+        });
+
+        benchmark_it("[abbreviations]", [&]{
+            ArgumentParser parser({"app", "--verb", "--out=file", "--in", "x", "--ver", "--no"});
+            parser.enableAbbreviations();
+            parser.addArgument("", "verbose", "", Argument::Boolean);
+            parser.addArgument("", "version", "", Argument::Boolean);
+            parser.addArgument("", "output", "");
+            parser.addArgument("", "in", "");
+            parser.addArgument("", "input", "");
+            parser.addArgument("", "nothing", "", Argument::Boolean);
+            const auto res = parser.parse();
+
+            AssertThat(res, Equals(ArgumentParserResult::AmbiguousArgument));
+            AssertThat(parser.ambiguousArguments(), Equals(StringList{"--ver"}));
+
+            ArgumentSchema schema;
+            schema.addArgument("", "verbose", "", Argument::Boolean);
+            schema.addArgument("", "output", "");
+            schema.addArgument("", "in", "");
+            schema.addArgument("", "input", "");
+            schema.enableAbbreviations();
+            schema.addArgument("", "nothing", "", Argument::Boolean);
+
+            const std::vector<std::string> args{"app", "--verb", "--out=file", "--in", "x", "--inp", "y", "--no"};
+            const auto parsed = schema.parse(args);
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed.exists("verbose"), IsTrue());
+            AssertThat(parsed.get("output"), Equals("file"));
+            AssertThat(parsed.get("in"), Equals("x")); // exact names win over longer ones
+            AssertThat(parsed.get("input"), Equals("y"));
+            AssertThat(parsed.exists("nothing"), IsTrue());
+
+            schema.enableAbbreviations(false);
+            AssertThat(schema.parse({"app", "--verb"}).exists("verbose"), IsFalse());
+        });
+
+        const auto abbreviationScaling = [](std::size_t optionCount) {
+            ArgumentSchema schema;
+            schema.enableAbbreviations();
+            for (auto i = 0u; i < optionCount; ++i)
+            {
+                schema.addArgument("", "option-" + std::to_string(i) + "-with-a-long-name", "");
+            }
+
+            std::vector<std::string> args{"app"};
+            for (auto i = 0u; i < optionCount; ++i)
+            {
+                args.emplace_back("--option-" + std::to_string(i) + "-");
+                args.emplace_back("value" + std::to_string(i));
+            }
+            const auto parsed = schema.parse(args);
+
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed.get("option-0-with-a-long-name"), Equals("value0"));
+            AssertThat(parsed.get("option-" + std::to_string(optionCount - 1) + "-with-a-long-name"), Equals("value" + std::to_string(optionCount - 1)));
+        };
+
+        benchmark_it("[abbreviationScaling10]", [&]{
+            abbreviationScaling(10);
+        });
+
+        benchmark_it("[abbreviationScaling1000]", [&]{
+            abbreviationScaling(1000);
+        });
+
+        benchmark_it("[abbreviationScaling10000]", [&]{
+            abbreviationScaling(10000);
+        });
+
+        // parsing only allocates to store results, values are views into the command line
+        benchmark_it("[allocationFreeParsing]", [&]{
+            std::vector<std::string> args{"app"};
+            for (auto i = 0u; i < 1000; ++i)
+            {
+                args.emplace_back("--option" + std::to_string(i));
+                args.emplace_back("a long value which doesn't fit into the small string buffer " + std::to_string(i));
+                args.emplace_back("-f");
+            }
+
+            ArgumentParser parser(CommandLine{args});
+            parser.addArgument("f", "flag", "", Argument::Boolean);
+            for (auto i = 0u; i < 1000; ++i)
+            {
+                parser.addArgument("", "option" + std::to_string(i), "");
+            }
+
+            ArgumentParserResult res;
+            const auto count = allocations::count([&]{
+                res = parser.parse();
+            });
+
+            AssertThat(res, Equals(ArgumentParserResult::Success));
+            AssertThat(count, Equals(1u)); // the result slots
+            AssertThat(parser.exists("flag"), IsTrue());
+            AssertThat(parser.get("option999"), Equals("a long value which doesn't fit into the small string buffer 999"));
+
+            // storing lose arguments is the only other allocation
+            ArgumentParser parser2({"app", "--flag", "lose1", "-f", "lose2"});
+            parser2.addArgument("f", "flag", "", Argument::Boolean);
+            const auto count2 = allocations::count([&]{
+                res = parser2.parse();
+            });
+
+            AssertThat(res, Equals(ArgumentParserResult::Success));
+            AssertThat(count2, Equals(3u));
+            AssertThat(parser2.loseArguments(), Equals(StringList{"lose1", "lose2"}));
+        });
+
+        // parsers with different option prefixes must not influence each other,
+        // build with ARGPARSE_TESTS_TSAN=ON to let ThreadSanitizer verify this test
+        benchmark_it("[concurrentParsing]", [&]{
+            const auto parseWithPrefixes = [](const std::string &shortPrefix, const std::string &longPrefix) {
+                ArgumentParser parser({"app", longPrefix + "value", "abc", shortPrefix + "f", "lose"}, shortPrefix, longPrefix);
+                parser.addArgument("", "value", "");
+                parser.addArgument("f", "flag", "", Argument::Boolean);
+                return
+                    parser.parse() == ArgumentParserResult::Success &&
+                    parser.get("value") == "abc" &&
+                    parser.exists("flag") &&
+                    parser.loseArguments() == StringList{"lose"};
+            };
+
+            std::atomic<unsigned> failures{0};
+            std::vector<std::thread> threads;
+            for (auto t = 0u; t < 8; ++t)
+            {
+                threads.emplace_back([&, t]{
+                    for (auto i = 0u; i < 500; ++i)
+                    {
+                        const bool ok = (t % 2 == 0) ? parseWithPrefixes("-", "--") : parseWithPrefixes("/", "//");
+                        if (!ok)
+                        {
+                            ++failures;
+                        }
+                    }
+                });
+            }
+            for (auto &thread : threads)
+            {
+                thread.join();
+            }
+
+            AssertThat(failures.load(), Equals(0u));
         });
     });
 });
@@ -74,5 +74,22 @@ go_bandit([]{
 
             AssertThat(fmt, Equals(expected));
         });
+
+        benchmark_it("[positionals]", [&]{
+            ArgumentParser parser({"app"});
+            parser.addHelpOption("Print this help and exit");
+            parser.addPositional("source", "Files to copy", Positional::AtLeastOne);
+            parser.addPositional("destination", "Target directory");
+            parser.addPositional("mode", "Copy mode", Positional::Optional);
+
+            const auto fmt = parser.help();
+            const auto expected =
+                "    -h, --help            Print this help and exit\n"
+                "    source...             Files to copy\n"
+                "    destination           Target directory\n"
+                "    [mode]                Copy mode\n";
+
+            AssertThat(fmt, Equals(expected));
+        });
     });
 });
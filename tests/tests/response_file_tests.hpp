@@ -0,0 +1,120 @@
+#include <bandit/bandit.h>
+
+#include "benchmark.hpp"
+
+using namespace snowhouse;
+using namespace bandit;
+
+#include <argparse/argparse.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+go_bandit([]{
+    describe("ResponseFiles", []{
+        using namespace argparse;
+
+        // writes a response file into the temporary directory and returns its path
+        const auto writeFile = [](const std::string &name, const std::string &content) {
+            const auto path = std::filesystem::temp_directory_path() / ("argparse-tests-" + name);
+            std::ofstream(path, std::ios::binary) << content;
+            return path.string();
+        };
+
+        benchmark_it("[tokenize]", [&]{
+            const auto file = writeFile("tokenize", R"(
+                # comment line
+                --value 'single quoted' --flag
+                "double \"quoted\" \\ value"  escaped\ space
+                mixed'quo'"ted" '' '@quoted'
+            )");
+
+            ArgumentParser parser({"app", "first", "@" + file, "last"});
+            parser.enableResponseFiles();
+            parser.addArgument("", "value", "");
+            parser.addArgument("", "flag", "", Argument::Boolean);
+            const auto res = parser.parse();
+
+            AssertThat(res, Equals(ArgumentParserResult::Success));
+            AssertThat(parser.get("value"), Equals("single quoted"));
+            AssertThat(parser.exists("flag"), IsTrue());
+            AssertThat(parser.loseArguments(), Equals(StringList{
+                "first", "double \"quoted\" \\ value", "escaped space", "mixedquoted", "", "@quoted", "last"}));
+        });
+
+        benchmark_it("[disabled]", [&]{
+            ArgumentParser parser({"app", "@does-not-exist"});
+            const auto res = parser.parse();
+
+            AssertThat(res, Equals(ArgumentParserResult::Success));
+            AssertThat(parser.loseArguments(), Equals(StringList{"@does-not-exist"}));
+        });
+
+        benchmark_it("[nested]", [&]{
+            const auto inner = writeFile("inner", "--value inner");
+            const auto outer = writeFile("outer", "--flag @" + inner + " -- @" + inner);
+
+            ArgumentParser parser({"app", "@" + outer, "remaining"});
+            parser.enableResponseFiles();
+            parser.setTerminator();
+            parser.addArgument("", "value", "");
+            parser.addArgument("", "flag", "", Argument::Boolean);
+            const auto res = parser.parse();
+
+            AssertThat(res, Equals(ArgumentParserResult::Success));
+            AssertThat(parser.get("value"), Equals("inner"));
+            AssertThat(parser.exists("flag"), IsTrue());
+            AssertThat(parser.remainingArguments(), Equals(StringList{("@" + inner).c_str(), "remaining"}));
+        });
+
+        benchmark_it("[errors]", [&]{
+            const auto recursive = (std::filesystem::temp_directory_path() / "argparse-tests-recursive").string();
+            writeFile("recursive", "x @" + recursive);
+
+            ArgumentParser parser({"app", "@" + recursive});
+            parser.enableResponseFiles(4);
+            AssertThat(parser.parse(), Equals(ArgumentParserResult::ResponseFileNesting));
+
+            ArgumentParser parser2({"app", "@" + std::filesystem::temp_directory_path().string() + "/argparse-tests-missing"});
+            parser2.enableResponseFiles();
+            AssertThat(parser2.parse(), Equals(ArgumentParserResult::ResponseFileError));
+
+            const auto unterminated = writeFile("unterminated", "--value 'abc");
+            ArgumentParser parser3({"app", "@" + unterminated});
+            parser3.enableResponseFiles();
+            AssertThat(parser3.parse(), Equals(ArgumentParserResult::ResponseFileError));
+
+            // the depth doesn't wrap around at the largest maximum
+            ArgumentParser parser4({"app", "@" + recursive});
+            parser4.enableResponseFiles(255);
+            AssertThat(parser4.parse(), Equals(ArgumentParserResult::ResponseFileNesting));
+        });
+
+        benchmark_it("[comments]", [&]{
+            const auto file = writeFile("comments", "# comment\n  # indented comment\nfirst #second\n#third\nfourth");
+
+            ArgumentParser parser({"app", "@" + file});
+            parser.enableResponseFiles();
+            AssertThat(parser.parse(), Equals(ArgumentParserResult::Success));
+            AssertThat(parser.loseArguments(), Equals(StringList{"first", "#second", "fourth"}));
+        });
+
+        benchmark_it("[200kPaths]", [&]{
+            std::string content;
+            for (auto i = 0u; i < 200000; ++i)
+            {
+                content += "/usr/share/some/long/path/to/file-" + std::to_string(i) + ".txt\n";
+            }
+            const auto file = writeFile("paths", content);
+
+            ArgumentSchema schema;
+            schema.enableResponseFiles();
+            const std::vector<std::string> args{"app", "@" + file};
+            const auto parsed = schema.parse(args);
+
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed.loseArguments().size(), Equals(200000u));
+            AssertThat(std::string_view(parsed.loseArguments().back()), Equals("/usr/share/some/long/path/to/file-199999.txt"));
+        });
+    });
+});
@@ -0,0 +1,417 @@
+#include <bandit/bandit.h>
+
+#include "benchmark.hpp"
+#include "environment.hpp"
+#include "allocations.hpp"
+
+using namespace snowhouse;
+using namespace bandit;
+
+#include <argparse/schema.hpp>
+
+#include <thread>
+#include <atomic>
+#include <array>
+#include <memory_resource>
+#include <cstdlib>
+
+go_bandit([]{
+    describe("Schema", []{
+        using namespace argparse;
+
+        const auto registerDefaultArguments = [](ArgumentSchema &schema) {
+            schema.addHelpOption("Print this help and quit");
+            schema.addArgument("v", "version", "Show application version", Argument::Boolean);
+            schema.addArgument("", "value", "");
+            schema.addArgument("", "required", "", "default", Argument::String, true);
+        };
+
+        benchmark_it("[multipleCommandLines]", [&]{
+            ArgumentSchema schema;
+            registerDefaultArguments(schema);
+
+            const std::vector<std::string> args1{"app", "--help", "--value", "abc"};
+            const std::vector<std::string> args2{"app", "-v", "lose", "--required", "xyz"};
+
+            const auto parsed1 = schema.parse(args1);
+            const auto parsed2 = schema.parse(args2);
+
+            AssertThat(parsed1.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed1.exists("help"), IsTrue());
+            AssertThat(parsed1.exists("version"), IsFalse());
+            AssertThat(parsed1.get("value"), Equals("abc"));
+            AssertThat(parsed1.get("required"), Equals("default"));
+            AssertThat(parsed1.loseArguments(), Equals(StringList{}));
+
+            AssertThat(parsed2.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed2.exists("help"), IsFalse());
+            AssertThat(parsed2.exists("v"), IsTrue());
+            AssertThat(parsed2.exists("value"), IsFalse());
+            AssertThat(parsed2.get("required"), Equals("xyz"));
+            AssertThat(parsed2.loseArguments(), Equals(StringList{"lose"}));
+        });
+
+        benchmark_it("[missingArgument]", [&]{
+            ArgumentSchema schema;
+            schema.addArgument("", "required", "", Argument::String, true);
+
+            const std::vector<std::string> args{"app", "--other"};
+            const auto parsed = schema.parse(args);
+
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::MissingArgument));
+            AssertThat(parsed.missingArguments(), Equals(StringList{"required"}));
+            AssertThat(parsed.exists("required"), IsFalse());
+        });
+
+        // the same schema is used by all threads without synchronization
+        benchmark_it("[sharedBetweenThreads]", [&]{
+            ArgumentSchema schema;
+            registerDefaultArguments(schema);
+
+            std::atomic<unsigned> failures{0};
+            std::vector<std::thread> threads;
+            for (auto t = 0u; t < 8; ++t)
+            {
+                threads.emplace_back([&, t]{
+                    const std::vector<std::string> args{"app", "--value", std::to_string(t), "-v"};
+                    for (auto i = 0u; i < 500; ++i)
+                    {
+                        const auto parsed = schema.parse(args);
+                        if (parsed.result() != ArgumentParserResult::Success ||
+                            parsed.get<unsigned>("value") != t || !parsed.exists("version"))
+                        {
+                            ++failures;
+                        }
+                    }
+                });
+            }
+            for (auto &thread : threads)
+            {
+                thread.join();
+            }
+
+            AssertThat(failures.load(), Equals(0u));
+        });
+
+        // only the result object is created per command line
+        benchmark_it("[reuse50k]", [&]{
+            ArgumentSchema schema;
+            registerDefaultArguments(schema);
+            for (auto i = 0u; i < 50; ++i)
+            {
+                schema.addArgument("", "option" + std::to_string(i), "");
+            }
+
+            const std::vector<std::string> args{"app", "--option10", "a", "--option20", "b", "-v", "--value", "c"};
+            auto successful = 0u;
+            for (auto i = 0u; i < 50000; ++i)
+            {
+                const auto parsed = schema.parse(args);
+                if (parsed.result() == ArgumentParserResult::Success)
+                {
+                    ++successful;
+                }
+            }
+
+            AssertThat(successful, Equals(50000u));
+        });
+
+        benchmark_it("[typedValues]", [&]{
+            ArgumentSchema schema;
+            schema.addArgument("j", "threads", "");
+            schema.addArgument("", "ratio", "", "0.5", Argument::String, true);
+            schema.addArgument("", "name", "");
+
+            const std::vector<std::string> args{"app", "--threads", "8", "--name", "abc"};
+            const auto parsed = schema.parse(args);
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+
+            // the first type is cached, other types are still converted
+            AssertThat(parsed.get<int>("threads"), Equals(8));
+            AssertThat(parsed.get<int>("j"), Equals(8));
+            AssertThat(parsed.get<double>("threads"), Equals(8.0));
+            AssertThat(parsed.get<std::string>("threads"), Equals("8"));
+            AssertThat(parsed.get<double>("ratio"), Equals(0.5));
+
+            // failed conversions are cached as well
+            bool ok = true;
+            AssertThat(parsed.get<int>("name", &ok), Equals(0));
+            AssertThat(ok, IsFalse());
+            AssertThat(parsed.get<int>("name", &ok), Equals(0));
+            AssertThat(ok, IsFalse());
+
+            const auto copy = parsed;
+            AssertThat(copy.get<int>("threads"), Equals(8));
+            AssertThat(copy.get<double>("ratio"), Equals(0.5));
+        });
+
+        benchmark_it("[typedValuesConcurrent]", [&]{
+            ArgumentSchema schema;
+            schema.addArgument("j", "threads", "");
+            const std::vector<std::string> args{"app", "--threads", "8"};
+            const auto parsed = schema.parse(args);
+
+            std::atomic<unsigned> failures{0};
+            std::vector<std::thread> threads;
+            for (auto t = 0u; t < 8; ++t)
+            {
+                threads.emplace_back([&]{
+                    for (auto i = 0u; i < 1000; ++i)
+                    {
+                        if (parsed.get<int>("threads") != 8)
+                        {
+                            ++failures;
+                        }
+                    }
+                });
+            }
+            for (auto &thread : threads)
+            {
+                thread.join();
+            }
+
+            AssertThat(failures.load(), Equals(0u));
+        });
+
+        benchmark_it("[typedValues1M]", [&]{
+            ArgumentSchema schema;
+            schema.addArgument("j", "threads", "");
+            schema.addArgument("", "scale", "");
+            const std::vector<std::string> args{"app", "--threads", "8", "--scale", "1.25"};
+            const auto parsed = schema.parse(args);
+
+            long long sum = 0;
+            double scale = 0;
+            for (auto i = 0u; i < 1000000; ++i)
+            {
+                sum += parsed.get<int>("threads");
+                scale += parsed.get<double>("scale");
+            }
+            AssertThat(sum, Equals(8000000));
+            AssertThat(scale, Equals(1250000.0));
+        });
+
+        // arguments, definitions and results are stored in contiguous arrays
+        benchmark_it("[largeSchema2k]", [&]{
+            std::vector<std::string> names;
+            std::vector<std::string> args{"app"};
+            for (auto i = 0u; i < 2000; ++i)
+            {
+                names.emplace_back("option-" + std::to_string(i));
+                if (i % 2 == 0)
+                {
+                    args.emplace_back("--" + names.back());
+                    args.emplace_back("value");
+                }
+            }
+
+            const auto registerArguments = [&](ArgumentSchema &schema) {
+                for (auto &&name : names)
+                {
+                    schema.addArgument("", name, "");
+                }
+            };
+
+            ArgumentSchema grown;
+            const auto grownAllocations = allocations::count([&]{ registerArguments(grown); });
+
+            ArgumentSchema reserved;
+            const auto reservedAllocations = allocations::count([&]{
+                reserved.reserve(names.size());
+                registerArguments(reserved);
+            });
+            AssertThat(reservedAllocations, IsLessThan(grownAllocations));
+
+            std::string help;
+            const auto helpAllocations = allocations::count([&]{ help = reserved.help(true); });
+            AssertThat(helpAllocations, IsLessThan(names.size() * 4));
+
+            // a parse only allocates the result slots when there are no lose arguments
+            ParsedArguments parsed;
+            const auto parseAllocations = allocations::count([&]{ parsed = reserved.parse(args); });
+            AssertThat(parseAllocations, Equals(1u));
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed.get("option-1998"), Equals("value"));
+            AssertThat(parsed.exists("option-1999"), IsFalse());
+        });
+
+        benchmark_it("[environmentVariables]", [&]{
+            ArgumentSchema schema;
+            schema.addArgument("j", "jobs", "", "1");
+            schema.addArgument("", "output", "", "a.out", Argument::String, true);
+            schema.addArgument("", "token", "", Argument::String, true);
+            schema.addArgument("", "color", "", Argument::Boolean);
+            schema.addArgument("", "quiet", "", Argument::Boolean);
+            AssertThat(schema.setEnvironmentVariable("jobs", "ARGPARSE_TEST_JOBS"), IsTrue());
+            AssertThat(schema.setEnvironmentVariable("output", "ARGPARSE_TEST_OUTPUT"), IsTrue());
+            AssertThat(schema.setEnvironmentVariable("token", "ARGPARSE_TEST_TOKEN"), IsTrue());
+            AssertThat(schema.setEnvironmentVariable("color", "ARGPARSE_TEST_COLOR"), IsTrue());
+            AssertThat(schema.setEnvironmentVariable("quiet", "ARGPARSE_TEST_QUIET"), IsTrue());
+            AssertThat(schema.setEnvironmentVariable("quiet", "ARGPARSE_TEST_JOBS"), IsFalse());
+            AssertThat(schema.setEnvironmentVariable("unknown", "ARGPARSE_TEST_UNKNOWN"), IsFalse());
+
+            environment::set("ARGPARSE_TEST_JOBS", "8");
+            environment::set("ARGPARSE_TEST_TOKEN", "secret");
+            environment::set("ARGPARSE_TEST_COLOR", "true");
+            environment::set("ARGPARSE_TEST_QUIET", "0");
+
+            // command line > environment > default value
+            const std::vector<std::string> args{"app", "--token", "given"};
+            const auto parsed = schema.parse(args);
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed.get<int>("jobs"), Equals(8));
+            AssertThat(parsed.get("output"), Equals("a.out"));
+            AssertThat(parsed.get("token"), Equals("given"));
+            AssertThat(parsed.exists("color"), IsTrue());
+            AssertThat(parsed.exists("quiet"), IsFalse());
+
+            // required arguments can be supplied by the environment alone
+            const std::vector<std::string> args2{"app", "--jobs", "2"};
+            const auto parsed2 = schema.parse(args2);
+            AssertThat(parsed2.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed2.get<int>("jobs"), Equals(2));
+            AssertThat(parsed2.get("token"), Equals("secret"));
+
+            environment::unset("ARGPARSE_TEST_TOKEN");
+            AssertThat(schema.parse(args2).result(), Equals(ArgumentParserResult::MissingArgument));
+
+            environment::unset("ARGPARSE_TEST_JOBS");
+            environment::unset("ARGPARSE_TEST_COLOR");
+            environment::unset("ARGPARSE_TEST_QUIET");
+        });
+
+        // the environment is scanned once per parse, not once per argument
+        benchmark_it("[environmentScaling]", [&]{
+            ArgumentSchema schema;
+            schema.reserve(500);
+            for (auto i = 0u; i < 500; ++i)
+            {
+                const auto name = "option-" + std::to_string(i);
+                schema.addArgument("", name, "");
+                schema.setEnvironmentVariable(name, "ARGPARSE_TEST_OPTION_" + std::to_string(i));
+            }
+            environment::set("ARGPARSE_TEST_OPTION_499", "value");
+
+            const std::vector<std::string> args{"app", "--option-0", "given"};
+            for (auto i = 0u; i < 1000; ++i)
+            {
+                const auto parsed = schema.parse(args);
+                AssertThat(parsed.get("option-499"), Equals("value"));
+            }
+
+            environment::unset("ARGPARSE_TEST_OPTION_499");
+        });
+
+        benchmark_it("[subcommands]", [&]{
+            ArgumentSchema schema;
+            schema.addArgument("v", "verbose", "", Argument::Boolean);
+            schema.addArgument("C", "", "");
+            schema.addSubcommand("commit", "Record changes", [](ArgumentSchema &commit) {
+                commit.addArgument("m", "message", "", Argument::String, true);
+                commit.addArgument("", "amend", "", Argument::Boolean);
+            });
+            schema.addSubcommand("status", "Show the working tree status", [](ArgumentSchema &status) {
+                status.addArgument("s", "short", "", Argument::Boolean);
+            });
+            AssertThat(schema.addSubcommand("status", "", [](ArgumentSchema &) {}), IsFalse());
+
+            const std::vector<std::string> args{"app", "-v", "-C", "status", "commit", "-m", "message", "--verbose", "lose"};
+            const auto parsed = schema.parse(args);
+
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed.exists("verbose"), IsTrue());
+            AssertThat(parsed.get("C"), Equals("status")); // option values don't select subcommands
+            AssertThat(parsed.subcommandName(), Equals("commit"));
+            AssertThat(parsed.subcommand() != nullptr, IsTrue());
+            AssertThat(parsed.subcommand()->get("message"), Equals("message"));
+            AssertThat(parsed.subcommand()->exists("amend"), IsFalse());
+            AssertThat(parsed.subcommand()->loseArguments(), Equals(StringList{"lose"})); // options of the parent are unknown
+            AssertThat(schema.subcommands()[0].created(), IsTrue());
+            AssertThat(schema.subcommands()[1].created(), IsFalse());
+
+            // errors of the subcommand are the result of the parse
+            const std::vector<std::string> args2{"app", "commit", "--amend"};
+            const auto parsed2 = schema.parse(args2);
+            AssertThat(parsed2.result(), Equals(ArgumentParserResult::MissingArgument));
+            AssertThat(parsed2.subcommand()->missingArguments(), Equals(StringList{"message"}));
+
+            const std::vector<std::string> args3{"app", "-v"};
+            const auto parsed3 = schema.parse(args3);
+            AssertThat(parsed3.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed3.subcommand() == nullptr, IsTrue());
+            AssertThat(parsed3.subcommandName(), Equals(""));
+
+            AssertThat(schema.subcommand("status")->help(false), Equals("    -s, --short           \n"));
+            AssertThat(schema.subcommand("unknown") == nullptr, IsTrue());
+        });
+
+        // only the factory of the selected subcommand runs, the other
+        // subcommands cost the same no matter how many options they have
+        benchmark_it("[lazySubcommands]", [&]{
+            std::atomic<unsigned> factories{0};
+
+            ArgumentSchema schema;
+            schema.addHelpOption("Print this help and exit");
+            for (auto i = 0u; i < 150; ++i)
+            {
+                schema.addSubcommand("command-" + std::to_string(i), "", [&factories](ArgumentSchema &command) {
+                    ++factories;
+                    command.reserve(200);
+                    for (auto j = 0u; j < 200; ++j)
+                    {
+                        command.addArgument("", "option-" + std::to_string(j), "");
+                    }
+                });
+            }
+
+            const std::vector<std::string> args{"app", "command-42", "--option-199", "value"};
+            const auto parsed = schema.parse(args);
+
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed.subcommand()->get("option-199"), Equals("value"));
+            AssertThat(factories.load(), Equals(1u));
+
+            // the help lists the subcommands without creating them
+            const auto help = schema.help(false);
+            AssertThat(help.find("command-149") != std::string::npos, IsTrue());
+            AssertThat(factories.load(), Equals(1u));
+
+            // concurrent requests of the same subcommand run its factory once
+            std::vector<std::thread> threads;
+            for (auto i = 0u; i < 4; ++i)
+            {
+                threads.emplace_back([&]{ schema.subcommand("command-7"); });
+            }
+            for (auto &&thread : threads)
+            {
+                thread.join();
+            }
+            AssertThat(factories.load(), Equals(2u));
+        });
+
+        // results allocated from a per-request arena don't touch the global heap
+        benchmark_it("[memoryResource]", [&]{
+            ArgumentSchema schema;
+            registerDefaultArguments(schema);
+
+            std::vector<std::string> args{"app", "--value", "abc", "--required", "xyz"};
+            for (auto i = 0u; i < 100; ++i)
+            {
+                args.emplace_back("a lose argument which doesn't fit into the small string buffer " + std::to_string(i));
+            }
+
+            std::array<std::byte, 64 * 1024> buffer;
+            std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+            const auto count = allocations::count([&]{
+                const auto parsed = schema.parse(args, &arena);
+
+                AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+                AssertThat(parsed.resource(), Equals(&arena));
+                AssertThat(parsed.exists("value"), IsTrue());
+                AssertThat(parsed.loseArguments().size(), Equals(100u));
+            });
+            AssertThat(count, Equals(0u));
+        });
+    });
+});
@@ -0,0 +1,163 @@
+#include <bandit/bandit.h>
+
+#include "benchmark.hpp"
+#include "environment.hpp"
+
+using namespace snowhouse;
+using namespace bandit;
+
+#include <argparse/schema.hpp>
+
+#include <cstdlib>
+
+namespace static_schema_tests {
+    using namespace argparse;
+
+    static constexpr auto options = makeStaticSchema(
+        ArgumentDefinition("h", "help", "Print this help and quit", Argument::Boolean),
+        ArgumentDefinition("v", "version", "Show application version", Argument::Boolean),
+        ArgumentDefinition("o", "output", "Output file"),
+        ArgumentDefinition("", "required", "", "default", Argument::String, true),
+        ArgumentDefinition("j", "", "Number of jobs"),
+        ArgumentDefinition("", "verbose", "", Argument::Boolean),
+        ArgumentDefinition("q", "quiet", "", Argument::Boolean),
+        ArgumentDefinition("", "include-directory", ""),
+        ArgumentDefinition("", "library-directory", ""),
+        ArgumentDefinition("D", "define", ""),
+        ArgumentDefinition("I", "include", ""),
+        ArgumentDefinition("L", "library", ""),
+        ArgumentDefinition("コ", "コマンド", ""));
+
+    // duplicates are detected at compile time, `ArgumentSchema::fromStatic()` refuses them with a static_assert
+    static constexpr auto duplicateShortNames = makeStaticSchema(
+        ArgumentDefinition("v", "version", ""),
+        ArgumentDefinition("v", "verbose", ""));
+    static constexpr auto duplicateLongNames = makeStaticSchema(
+        ArgumentDefinition("v", "verbose", ""),
+        ArgumentDefinition("", "verbose", ""));
+
+    static_assert(options.isValid());
+    static_assert(!duplicateShortNames.isValid());
+    static_assert(!duplicateLongNames.isValid());
+
+    // the tables are usable in constant expressions too
+    static_assert(options.longIndex.view().candidate("output") == 2);
+    static_assert(options.shortIndex.view().candidate("j") == 4);
+}
+
+go_bandit([]{
+    describe("StaticSchema", []{
+        using namespace argparse;
+        using static_schema_tests::options;
+
+        benchmark_it("[perfectHash]", [&]{
+            const auto schema = ArgumentSchema::fromStatic<options>();
+
+            AssertThat(schema.definitions().size(), Equals(options.definitions.size()));
+            for (auto i = 0u; i < options.definitions.size(); ++i)
+            {
+                const auto &definition = options.definitions[i];
+                if (definition.hasShortName())
+                {
+                    AssertThat(schema.findShortName(definition.shortName()), Equals(i));
+                }
+                if (definition.hasLongName())
+                {
+                    AssertThat(schema.findLongName(definition.longName()), Equals(i));
+                }
+            }
+
+            AssertThat(schema.findLongName("unknown"), Equals(ArgumentSchema::npos));
+            AssertThat(schema.findLongName("h"), Equals(ArgumentSchema::npos));
+            AssertThat(schema.findShortName("help"), Equals(ArgumentSchema::npos));
+            AssertThat(schema.findShortName(""), Equals(ArgumentSchema::npos));
+        });
+
+        benchmark_it("[parse]", [&]{
+            auto schema = ArgumentSchema::fromStatic<options>();
+            AssertThat(schema.addArgument("", "added", ""), IsFalse());
+
+            const std::vector<std::string> args{"app", "-o", "file", "--verbose", "-j", "4", "lose", "--コマンド", "表示", "-qvIinclude"};
+            const auto parsed = schema.parse(args);
+
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed.get("output"), Equals("file"));
+            AssertThat(parsed.exists("verbose"), IsTrue());
+            AssertThat(parsed.exists("help"), IsFalse());
+            AssertThat(parsed.get<int>("j"), Equals(4));
+            AssertThat(parsed.get("required"), Equals("default"));
+            AssertThat(parsed.get("コ"), Equals("表示"));
+            AssertThat(parsed.exists("quiet"), IsTrue());
+            AssertThat(parsed.exists("version"), IsTrue());
+            AssertThat(parsed.get("include"), Equals("include"));
+            AssertThat(parsed.loseArguments(), Equals(StringList{"lose"}));
+        });
+
+        benchmark_it("[environmentVariables]", [&]{
+            static constexpr auto environment = makeStaticSchema(
+                ArgumentDefinition("", "cache", "", "/default").withEnvironmentVariable("ARGPARSE_TEST_STATIC_CACHE"),
+                ArgumentDefinition("", "color", "", Argument::Boolean).withEnvironmentVariable("ARGPARSE_TEST_STATIC_COLOR"));
+
+            environment::set("ARGPARSE_TEST_STATIC_CACHE", "/tmp/cache");
+            environment::set("ARGPARSE_TEST_STATIC_COLOR", "1");
+
+            const auto schema = ArgumentSchema::fromStatic<environment>();
+            const std::vector<std::string> args{"app"};
+            const auto parsed = schema.parse(args);
+
+            environment::unset("ARGPARSE_TEST_STATIC_CACHE");
+            environment::unset("ARGPARSE_TEST_STATIC_COLOR");
+
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed.get("cache"), Equals("/tmp/cache"));
+            AssertThat(parsed.exists("color"), IsTrue());
+        });
+
+        benchmark_it("[help]", [&]{
+            static constexpr auto small = makeStaticSchema(
+                ArgumentDefinition("h", "help", "Print this help and exit", Argument::Boolean),
+                ArgumentDefinition("s", "", "Just a short option"));
+
+            const auto schema = ArgumentSchema::fromStatic<small>();
+            const auto expected =
+                "    -h, --help           Print this help and exit\n"
+                "    -s [value]           Just a short option\n";
+
+            AssertThat(schema.help(true), Equals(expected));
+        });
+
+        // no registration work compared to building the same schema at runtime
+        benchmark_it("[startupStatic]", [&]{
+            const std::vector<std::string> args{"app", "--output", "file"};
+            for (auto i = 0u; i < 10000; ++i)
+            {
+                const auto schema = ArgumentSchema::fromStatic<options>();
+                AssertThat(schema.parse(args).result(), Equals(ArgumentParserResult::Success));
+            }
+        });
+
+        benchmark_it("[startupRuntime]", [&]{
+            const std::vector<std::string> args{"app", "--output", "file"};
+            for (auto i = 0u; i < 10000; ++i)
+            {
+                ArgumentSchema schema;
+                for (auto &&definition : options.definitions)
+                {
+                    if (definition.hasDefaultValue())
+                    {
+                        schema.addArgument(
+                            std::string(definition.shortName()), std::string(definition.longName()), std::string(definition.description()),
+                            std::string(definition.defaultValue().value()), definition.type(), definition.required());
+                    }
+                    else
+                    {
+                        schema.addArgument(
+                            std::string(definition.shortName()), std::string(definition.longName()), std::string(definition.description()),
+                            definition.type(), definition.required());
+                    }
+                }
+                AssertThat(schema.parse(args).result(), Equals(ArgumentParserResult::Success));
+            }
+        });
+    });
+});
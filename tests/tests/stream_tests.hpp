@@ -0,0 +1,173 @@
+#include <bandit/bandit.h>
+
+#include "benchmark.hpp"
+#include "allocations.hpp"
+
+using namespace snowhouse;
+using namespace bandit;
+
+#include <argparse/schema.hpp>
+
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
+
+go_bandit([]{
+    describe("Stream", []{
+        using namespace argparse;
+
+        const auto registerDefaultArguments = [](ArgumentSchema &schema) {
+            schema.addArgument("v", "verbose", "", Argument::Boolean);
+            schema.addArgument("o", "output", "");
+            schema.addArgument("", "required", "", Argument::String, true);
+        };
+
+        // joins the records with NUL characters
+        const auto records = [](const std::vector<std::string> &args) {
+            std::string stream;
+            for (auto &&arg : args)
+            {
+                stream += arg;
+                stream += '\0';
+            }
+            return stream;
+        };
+
+        benchmark_it("[istream]", [&]{
+            ArgumentSchema schema;
+            registerDefaultArguments(schema);
+
+            // the small buffer forces records to be carried over between reads
+            std::istringstream stream(records({"-v", "first file", "--output", "/tmp/output", "--required=yes", "second"}));
+            const auto parsed = schema.parseStream(stream, {}, 16);
+
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed.exists("verbose"), IsTrue());
+            AssertThat(parsed.get("output"), Equals("/tmp/output"));
+            AssertThat(parsed.get("required"), Equals("yes"));
+            AssertThat(parsed.loseArguments(), Equals(StringList{"first file", "second"}));
+
+            std::istringstream unterminated(std::string("--required\0value", 16));
+            AssertThat(schema.parseStream(unterminated).get("required"), Equals("value"));
+
+            std::istringstream empty("");
+            AssertThat(schema.parseStream(empty).result(), Equals(ArgumentParserResult::InsufficientArguments));
+        });
+
+        benchmark_it("[recordTooLong]", [&]{
+            ArgumentSchema schema;
+            registerDefaultArguments(schema);
+
+            std::istringstream stream(records({"--required", std::string(64, 'x')}));
+            AssertThat(schema.parseStream(stream, {}, 32).result(), Equals(ArgumentParserResult::StreamError));
+        });
+
+        benchmark_it("[fileDescriptor]", [&]{
+            ArgumentSchema schema;
+            registerDefaultArguments(schema);
+
+            int fds[2];
+            AssertThat(::pipe(fds), Equals(0));
+
+            std::thread writer([&]{
+                const auto data = records({"--required", "x", "a", "b", "c"});
+                AssertThat(::write(fds[1], data.data(), data.size()), Equals(static_cast<ssize_t>(data.size())));
+                ::close(fds[1]);
+            });
+
+            std::vector<std::string> lose;
+            const auto parsed = schema.parseStream(fds[0], [&](std::string_view arg) { lose.emplace_back(arg); });
+            writer.join();
+            ::close(fds[0]);
+
+            AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+            AssertThat(parsed.get("required"), Equals("x"));
+            AssertThat(lose, Equals(std::vector<std::string>{"a", "b", "c"}));
+            AssertThat(parsed.loseArguments(), Equals(StringList{}));
+        });
+
+        // lose arguments passed to a handler keep the memory usage independent of the input size
+        benchmark_it("[boundedMemory1M]", [&]{
+            ArgumentSchema schema;
+            registerDefaultArguments(schema);
+
+            const auto streamFiles = [&](std::size_t files) {
+                std::string data = records({"--required", "x"});
+                for (auto i = 0u; i < files; ++i)
+                {
+                    data += "/usr/share/some/long/path/to/file-" + std::to_string(i) + ".txt";
+                    data += '\0';
+                }
+
+                std::istringstream stream(std::move(data));
+                std::size_t count = 0;
+                const ArgumentSchema::LoseArgumentHandler handler = [&](std::string_view) { ++count; };
+
+                const auto allocated = allocations::count([&]{
+                    AssertThat(schema.parseStream(stream, handler).result(), Equals(ArgumentParserResult::Success));
+                });
+                AssertThat(count, Equals(files));
+                return allocated;
+            };
+
+            AssertThat(streamFiles(1000000), Equals(streamFiles(10)));
+        });
+
+        // values beyond the positional arguments go to the handler and aren't stored
+        benchmark_it("[positionalsWithHandler]", [&]{
+            ArgumentSchema schema;
+            registerDefaultArguments(schema);
+            schema.addPositional("input", "");
+            schema.addPositional("output-dir", "", Positional::Optional);
+
+            const auto streamFiles = [&](std::size_t files) {
+                std::string data = records({"--required", "x", "input.txt", "out"});
+                for (auto i = 0u; i < files; ++i)
+                {
+                    data += "/usr/share/some/long/path/to/file-" + std::to_string(i) + ".txt";
+                    data += '\0';
+                }
+
+                std::istringstream stream(std::move(data));
+                std::size_t count = 0;
+                const ArgumentSchema::LoseArgumentHandler handler = [&](std::string_view) { ++count; };
+
+                const auto allocated = allocations::count([&]{
+                    const auto parsed = schema.parseStream(stream, handler);
+                    AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+                    AssertThat(parsed.positional("input"), Equals("input.txt"));
+                    AssertThat(parsed.positional("output-dir"), Equals("out"));
+                });
+                AssertThat(count, Equals(files));
+                return allocated;
+            };
+
+            AssertThat(streamFiles(100000), Equals(streamFiles(10)));
+        });
+
+        // repeated single value options overwrite their copy instead of adding one
+        benchmark_it("[repeatedOptions]", [&]{
+            ArgumentSchema schema;
+            registerDefaultArguments(schema);
+
+            const auto streamOutputs = [&](std::size_t outputs) {
+                std::string data = records({"--required", "x"});
+                for (auto i = 0u; i < outputs; ++i)
+                {
+                    data += records({"--output", "/usr/share/some/long/path/to/file-" + std::to_string(100000 + i) + ".txt"});
+                }
+
+                std::istringstream stream(std::move(data));
+                const auto allocated = allocations::count([&]{
+                    const auto parsed = schema.parseStream(stream);
+                    AssertThat(parsed.result(), Equals(ArgumentParserResult::Success));
+                    AssertThat(parsed.get("output"), Equals("/usr/share/some/long/path/to/file-" + std::to_string(100000 + outputs - 1) + ".txt"));
+                });
+                return allocated;
+            };
+
+            AssertThat(streamOutputs(100000), Equals(streamOutputs(10)));
+        });
+    });
+});